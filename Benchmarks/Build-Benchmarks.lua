@@ -0,0 +1,62 @@
+project "Benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	-- Core sources without the UI, run a Release build with "Benchmarks [name filter]"
+	files
+	{
+		"src/**.h",
+		"src/**.cpp",
+		"../LiveCalculator/src/**.h",
+		"../LiveCalculator/src/**.cpp"
+	}
+
+	removefiles
+	{
+		"../LiveCalculator/src/EntryPoint.cpp",
+		"../LiveCalculator/src/UI.h",
+		"../LiveCalculator/src/UI.cpp"
+	}
+
+	includedirs
+	{
+		"./src",
+		"../LiveCalculator/src",
+		"../KernelGenerator",
+		"../vendor/imgui"
+	}
+
+	-- Generated/GeneratedKernels.h is written by the KernelGenerator post-build step
+	dependson { "KernelGenerator" }
+
+	pchheader "Pch.h"
+	pchsource "../LiveCalculator/src/Pch.cpp"
+
+	targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+	filter "system:windows"
+		systemversion "latest"
+		defines { "WL_PLATFORM_WINDOWS" }
+
+	filter "system:linux"
+		links { "pthread" }
+
+	filter "configurations:Debug"
+		defines { "WL_DEBUG" }
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "WL_RELEASE" }
+		runtime "Release"
+		optimize "On"
+		symbols "On"
+
+	filter "configurations:Dist"
+		defines { "WL_DIST" }
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
@@ -0,0 +1,16 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+std::vector<Benchmark::BenchmarkCase>& Benchmark::GetBenchmarks()
+{
+	// Function local so registration from other translation units does not depend on initialization order
+	static std::vector<BenchmarkCase> Benchmarks;
+	return Benchmarks;
+}
+
+void Benchmark::Report(const std::string_view Name, const double Nanoseconds, const std::string_view Unit, const double UnitCount)
+{
+	printf("  %-48.*s %12.2f ns/%.*s\n", static_cast<int32_t>(Name.size()), Name.data(), Nanoseconds / UnitCount, static_cast<int32_t>(Unit.size()), Unit.data());
+}
@@ -0,0 +1,77 @@
+﻿#pragma once
+
+#include <chrono>
+
+/*
+ * Minimal benchmark registry. WL_BENCHMARK defines a benchmark and registers it before main() runs, Measure()
+ * times a callable and Report() prints one result line:
+ *
+ *		WL_BENCHMARK(Addition)
+ *		{
+ *			Benchmark::Report("1+2", Benchmark::Measure([] { Benchmark::DoNotOptimize(Test()); }));
+ *		}
+ */
+namespace Benchmark
+{
+	using BenchmarkFunction = void (*)();
+
+	struct BenchmarkCase
+	{
+		const char* Name;
+		BenchmarkFunction Function;
+	};
+
+	std::vector<BenchmarkCase>& GetBenchmarks();
+
+	struct Registrar
+	{
+		Registrar(const char* Name, const BenchmarkFunction Function)
+		{
+			GetBenchmarks().push_back({ Name, Function });
+		}
+	};
+
+	inline constexpr std::chrono::milliseconds MINIMUM_TIME{ 200 };
+
+	inline const void* volatile GSink = nullptr;
+
+	// Makes the compiler materialize Value, so the work producing it is not optimized away
+	template <typename T>
+	void DoNotOptimize(const T& Value)
+	{
+		GSink = &Value;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+
+	// Calls Function in growing batches until a batch takes MinimumTime, returns the nanoseconds per call
+	template <typename TFunction>
+	double Measure(TFunction&& Function, const std::chrono::nanoseconds MinimumTime = MINIMUM_TIME)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		for (uint64_t Iterations = 1;; Iterations *= 2)
+		{
+			const Clock::time_point Start = Clock::now();
+
+			for (uint64_t Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Function();
+			}
+
+			const Clock::duration Elapsed = Clock::now() - Start;
+
+			if (Elapsed >= MinimumTime)
+			{
+				return std::chrono::duration<double, std::nano>(Elapsed).count() / static_cast<double>(Iterations);
+			}
+		}
+	}
+
+	// Nanoseconds is divided by UnitCount, e.g. the number of nodes or characters one call worked on
+	void Report(std::string_view Name, double Nanoseconds, std::string_view Unit = "call", double UnitCount = 1.0);
+}
+
+#define WL_BENCHMARK(Name) \
+	static void Name(); \
+	static const Benchmark::Registrar Name##Registrar(#Name, Name); \
+	static void Name()
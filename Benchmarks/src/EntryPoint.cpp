@@ -0,0 +1,32 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "Interpreter/NumberPolicy.h"
+
+/*
+ * Runs every registered benchmark, or only those whose name contains the first argument.
+ * Usage: Benchmarks [name filter]
+ *
+ * Only Release and Dist builds give meaningful numbers.
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	const std::string_view Filter = ArgumentCount > 1 ? Arguments[1] : "";
+
+	printf("Number is built on %s\n", NumberPolicy::NAME);
+
+	for (const Benchmark::BenchmarkCase& Case : Benchmark::GetBenchmarks())
+	{
+		if (std::string_view(Case.Name).find(Filter) == std::string_view::npos)
+		{
+			continue;
+		}
+
+		printf("%s\n", Case.Name);
+		Case.Function();
+	}
+
+	return 0;
+}
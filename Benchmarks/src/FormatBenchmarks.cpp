@@ -0,0 +1,61 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "Interpreter/NumberFormat.h"
+
+#include <random>
+
+// Every notation of NumberFormat::Format against the std::format("{}") it replaced, on a mix of ints and fractions
+WL_BENCHMARK(FormatResults)
+{
+	std::mt19937_64 Random(38);
+	std::vector<Number> Values;
+
+	for (int32_t Index = 0; Index < 4096; ++Index)
+	{
+		const int64_t Numerator = static_cast<int64_t>(Random() % 2000000) - 1000000;
+
+		if (Index % 4 == 0)
+		{
+			Values.emplace_back(Numerator);
+		}
+		else
+		{
+			Values.emplace_back(static_cast<Number::FloatType>(Numerator) / static_cast<Number::FloatType>(Random() % 999 + 1));
+		}
+	}
+
+	const double ValueCount = static_cast<double>(Values.size());
+
+	Benchmark::Report("std::format", Benchmark::Measure([&]
+	{
+		for (const Number& Value : Values)
+		{
+			Benchmark::DoNotOptimize(Value.IsInt ? std::format("{}", Value.IntValue) : std::format("{}", Value.FloatValue));
+		}
+	}), "value", ValueCount);
+
+	const std::pair<const char*, FormatOptions> Formats[] =
+	{
+		{ "NumberFormat shortest", { NOTATION_SHORTEST } },
+		{ "NumberFormat fixed, 6 digits", { NOTATION_FIXED, 6 } },
+		{ "NumberFormat scientific", { NOTATION_SCIENTIFIC } },
+		{ "NumberFormat general, 10 digits", { NOTATION_GENERAL, 10 } },
+		{ "NumberFormat hex", { NOTATION_HEX } }
+	};
+
+	for (const auto& [Name, Options] : Formats)
+	{
+		Benchmark::Report(Name, Benchmark::Measure([&]
+		{
+			char Buffer[NumberFormat::MAX_LENGTH];
+
+			for (const Number& Value : Values)
+			{
+				Benchmark::DoNotOptimize(NumberFormat::Format(Buffer, Buffer + sizeof(Buffer), Value, Options));
+			}
+		}), "value", ValueCount);
+	}
+}
@@ -0,0 +1,66 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Jit/Jit.h"
+#include "Parser/Parser.h"
+
+static std::string GetLongSum(const int32_t TermCount)
+{
+	std::string Formula = "0";
+
+	for (int32_t Term = 1; Term < TermCount; ++Term)
+	{
+		Formula += std::format(" + {}.5 * {}", Term % 97, Term % 13 + 1);
+	}
+
+	return Formula;
+}
+
+// Compiling once and running the code against walking the tree every time
+WL_BENCHMARK(JitAgainstInterpreter)
+{
+	const std::string Formulas[] =
+	{
+		"3*4.5*4.5 - 2*4.5 + 7",
+		"(1 + 2) * (3 + 4) * (5 + 6) - 7 * 8",
+		"1/(1 + 2/(3 + 4/(5 + 6/7)))",
+		GetLongSum(1000)
+	};
+
+	for (const std::string& Formula : Formulas)
+	{
+		ErrorManager Errors;
+		SyntaxTree Tree;
+		const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+		const std::string Name = Formula.size() > 40 ? std::format("{} nodes", Tree.Nodes.size()) : Formula;
+
+		const std::unique_ptr<CompiledExpression> Compiled = Jit::Compile(Tree, Root);
+
+		if (Compiled == nullptr)
+		{
+			printf("  The JIT needs x86-64 and Number built on doubles (premake5 --number=double)\n");
+			return;
+		}
+
+		Benchmark::Report(std::format("{} Jit::Compile", Name), Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(Jit::Compile(Tree, Root));
+		}));
+
+		Benchmark::Report(std::format("{} CompiledExpression::Run", Name), Benchmark::Measure([&]
+		{
+			Number Result;
+			Benchmark::DoNotOptimize(Compiled->Run(Result));
+			Benchmark::DoNotOptimize(Result);
+		}));
+
+		Benchmark::Report(std::format("{} Interpreter::Visit", Name), Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(Interpreter::Visit(Tree, Root, Errors));
+		}));
+	}
+}
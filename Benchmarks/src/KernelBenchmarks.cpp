@@ -0,0 +1,41 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Parser/Parser.h"
+
+#include "Generated/GeneratedKernels.h"
+
+// Every kernel of KernelGenerator/Formulas.txt against interpreting its tree and against the whole pipeline
+WL_BENCHMARK(KernelsAgainstInterpreter)
+{
+	for (const Kernels::KernelEntry& Entry : Kernels::GKernels)
+	{
+		ErrorManager Errors;
+		SyntaxTree Tree;
+		const uint32_t Root = Parser::GetExpressionResult(Entry.Formula, Tree, Errors);
+
+		// Called through a volatile pointer so the compiler cannot fold the kernel into the loop
+		Number (*volatile Function)() = Entry.Function;
+
+		Benchmark::Report(std::format("{} kernel", Entry.Name), Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(Function());
+		}));
+
+		Benchmark::Report(std::format("{} Interpreter::Visit", Entry.Name), Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(Interpreter::Visit(Tree, Root, Errors));
+		}));
+
+		Benchmark::Report(std::format("{} lex, parse and interpret", Entry.Name), Benchmark::Measure([&]
+		{
+			SyntaxTree ScratchTree;
+			const uint32_t ScratchRoot = Parser::GetExpressionResult(Entry.Formula, ScratchTree, Errors);
+			Benchmark::DoNotOptimize(Interpreter::Visit(ScratchTree, ScratchRoot, Errors));
+		}));
+	}
+}
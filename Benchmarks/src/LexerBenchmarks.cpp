@@ -0,0 +1,40 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+
+// Serial lexing of about 1 MB of each literal form, the paths that GetNumberToken and GetNumberValue take
+WL_BENCHMARK(LexerLiterals)
+{
+	const std::pair<const char*, std::string_view> Forms[] =
+	{
+		{ "integers", "{} + " },
+		{ "floats", "{}.125 + " },
+		{ "hex", "0x{:x} + " },
+		{ "scientific", "{}e-7 + " },
+		{ "separators", "1_{:03}_000 + " }
+	};
+
+	ErrorManager Errors;
+
+	for (const auto& [Name, Format] : Forms)
+	{
+		std::string Input;
+
+		for (uint32_t Term = 0; Input.size() < 1024 * 1024; ++Term)
+		{
+			const uint32_t Value = Term % 1000;
+			Input += std::vformat(Format, std::make_format_args(Value));
+		}
+
+		Input += "1";
+
+		Benchmark::Report(Name, Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(Lexer::GetTokens(Input, Errors));
+		}), "character", static_cast<double>(Input.size()));
+	}
+}
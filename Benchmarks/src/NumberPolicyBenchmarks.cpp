@@ -0,0 +1,76 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Parser/Parser.h"
+
+#include <random>
+
+// One dependent chain, bound by the latency of the float type, and independent elements that may vectorize.
+// The chain telescopes, so it stays far from overflow and subnormals even for float.
+template <typename TPolicy>
+static void ReportArithmetic()
+{
+	using FloatType = typename TPolicy::FloatType;
+	using PolicyNumber = BasicNumber<TPolicy>;
+
+	std::mt19937_64 Random(49);
+	std::vector<PolicyNumber> Values;
+
+	for (int32_t Index = 0; Index < 4096; ++Index)
+	{
+		Values.emplace_back(static_cast<FloatType>(Random() % 1000 + 1) / FloatType(8));
+	}
+
+	std::vector<PolicyNumber> Results(Values.size() - 2);
+	const double OperationCount = static_cast<double>(Results.size()) * 2.0;
+
+	Benchmark::Report(std::format("{}, dependent chain", TPolicy::NAME), Benchmark::Measure([&]
+	{
+		PolicyNumber Result(FloatType(1));
+
+		for (size_t Index = 0; Index < Results.size(); ++Index)
+		{
+			Result = Result.MultipliedBy(Values[Index + 1]).DividedBy(Values[Index]);
+		}
+
+		Benchmark::DoNotOptimize(Result);
+	}), "operation", OperationCount);
+
+	Benchmark::Report(std::format("{}, independent elements", TPolicy::NAME), Benchmark::Measure([&]
+	{
+		for (size_t Index = 0; Index < Results.size(); ++Index)
+		{
+			Results[Index] = Values[Index].MultipliedBy(Values[Index + 1]).AddedTo(Values[Index + 2]);
+		}
+
+		Benchmark::DoNotOptimize(Results);
+	}), "operation", OperationCount);
+}
+
+// Number arithmetic on every policy in one binary, the interpreter on the policy this build uses
+WL_BENCHMARK(NumberPolicies)
+{
+	ReportArithmetic<LongDoublePolicy>();
+	ReportArithmetic<DoublePolicy>();
+	ReportArithmetic<FloatPolicy>();
+
+	std::string Input;
+
+	for (uint32_t Term = 0; Term < 20000; ++Term)
+	{
+		Input += std::format("{}{}.25 / 3.5", Term == 0 ? "" : Term % 3 != 0 ? " + " : " * ", Term % 97 + 1);
+	}
+
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Input, Tree, Errors);
+
+	Benchmark::Report(std::format("{}, Interpreter::Visit", NumberPolicy::NAME), Benchmark::Measure([&]
+	{
+		Benchmark::DoNotOptimize(Interpreter::Visit(Tree, Root, Errors));
+	}), "node", static_cast<double>(Tree.Nodes.size()));
+}
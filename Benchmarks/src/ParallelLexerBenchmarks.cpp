@@ -0,0 +1,37 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+#include "Lexer/ParallelLexer.h"
+
+// 32 MB of mixed literals and operators on 1 to hardware_concurrency() threads
+WL_BENCHMARK(ParallelLexerScaling)
+{
+	std::string Input;
+
+	for (uint32_t Term = 0; Input.size() < 32 * ParallelLexer::MIN_CHUNK_SIZE; ++Term)
+	{
+		Input += std::format("{}.25 * 0x{:x} - {}e-3 + ", Term % 1000, Term % 4096, Term % 77);
+	}
+
+	Input += "1";
+
+	const double CharacterCount = static_cast<double>(Input.size());
+	ErrorManager Errors;
+
+	Benchmark::Report("Lexer::GetTokens", Benchmark::Measure([&]
+	{
+		Benchmark::DoNotOptimize(Lexer::GetTokens(Input, Errors));
+	}), "character", CharacterCount);
+
+	for (uint32_t ThreadCount = 1; ThreadCount <= std::max(std::thread::hardware_concurrency(), 1u); ThreadCount *= 2)
+	{
+		Benchmark::Report(std::format("ParallelLexer::GetTokens, {} threads", ThreadCount), Benchmark::Measure([&]
+		{
+			Benchmark::DoNotOptimize(ParallelLexer::GetTokens(Input, Errors, ThreadCount));
+		}), "character", CharacterCount);
+	}
+}
@@ -0,0 +1,45 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Benchmark.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/RationalInterpreter.h"
+#include "Parser/Parser.h"
+
+// Exact mode against the floating path on the same tree. Integer-only formulas stay on the int64_t fast path of
+// Rational, fractional ones keep growing denominators and show what exactness costs.
+static void ReportExactAgainstFloating(const std::string_view Name, const std::string& Input)
+{
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Input, Tree, Errors);
+	const double NodeCount = static_cast<double>(Tree.Nodes.size());
+
+	Benchmark::Report(std::format("{}, Interpreter::Visit", Name), Benchmark::Measure([&]
+	{
+		Benchmark::DoNotOptimize(Interpreter::Visit(Tree, Root, Errors));
+	}), "node", NodeCount);
+
+	Benchmark::Report(std::format("{}, RationalInterpreter::Visit", Name), Benchmark::Measure([&]
+	{
+		Benchmark::DoNotOptimize(RationalInterpreter::Visit(Tree, Root, Errors, nullptr, Input));
+	}), "node", NodeCount);
+}
+
+WL_BENCHMARK(RationalAgainstFloating)
+{
+	std::string Integers;
+	std::string Fractions;
+
+	for (uint32_t Term = 0; Term < 200; ++Term)
+	{
+		const char* Operator = Term == 0 ? "" : Term % 3 != 0 ? " + " : " - ";
+		Integers += std::format("{}{} * {}", Operator, Term % 97 + 1, Term % 13 + 2);
+		Fractions += std::format("{}{} / {} * 0.25", Operator, Term % 97 + 1, Term % 13 + 2);
+	}
+
+	ReportExactAgainstFloating("Integer-only", Integers);
+	ReportExactAgainstFloating("Fractional", Fractions);
+}
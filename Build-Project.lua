@@ -1,4 +1,24 @@
 -- premake5.lua
+newoption
+{
+   trigger = "tracing",
+   description = "Record Chrome trace events of the evaluation pipeline"
+}
+
+newoption
+{
+   trigger = "number",
+   value = "POLICY",
+   description = "Floating-point type of Number, see LiveCalculator/src/Interpreter/NumberPolicy.h",
+   default = "longdouble",
+   allowed =
+   {
+      { "longdouble", "long double (default)" },
+      { "double", "double" },
+      { "float", "float" }
+   }
+}
+
 workspace "LiveCalculator"
    architecture "x64"
    configurations { "Debug", "Release", "Dist" }
@@ -8,7 +28,39 @@ workspace "LiveCalculator"
    filter "system:windows"
       buildoptions { "/EHsc", "/Zc:preprocessor", "/Zc:__cplusplus" }
 
+   -- "premake5 --tracing <action>" compiles in the trace events of LiveCalculator/src/Trace.h
+   filter "options:tracing"
+      defines { "WL_ENABLE_TRACING" }
+
+   -- "premake5 --number=double <action>" builds the whole engine on doubles instead of long doubles
+   filter "options:number=double"
+      defines { "WL_NUMBER_DOUBLE" }
+
+   filter "options:number=float"
+      defines { "WL_NUMBER_FLOAT" }
+
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 include "Build-External.lua"
-include "LiveCalculator/Build-LiveCalculator.lua"
\ No newline at end of file
+include "LiveCalculator/Build-LiveCalculator.lua"
+
+group "Tools"
+   include "KernelGenerator/Build-KernelGenerator.lua"
+group ""
+
+group "Tests"
+   include "Tests/Build-Tests.lua"
+   include "Benchmarks/Build-Benchmarks.lua"
+group ""
+
+-- Linux only, generate with "premake5 gmake2" and build with "make EvalServer LoadGenerator"
+if os.target() == "linux" then
+   group "Server"
+      include "EvalServer/Build-EvalServer.lua"
+      include "LoadGenerator/Build-LoadGenerator.lua"
+   group ""
+
+   group "Fuzz"
+      include "Fuzz/Build-Fuzz.lua"
+   group ""
+end
\ No newline at end of file
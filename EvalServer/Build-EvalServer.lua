@@ -0,0 +1,64 @@
+project "EvalServer"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	-- Linux daemon (epoll), builds the core sources without the UI
+	files
+	{
+		"src/**.h",
+		"src/**.cpp",
+		"../LiveCalculator/src/Pch.h",
+		"../LiveCalculator/src/Pch.cpp",
+		"../LiveCalculator/src/Cache/**.h",
+		"../LiveCalculator/src/Cache/**.cpp",
+		"../LiveCalculator/src/ErrorManager.h",
+		"../LiveCalculator/src/ErrorManager.cpp",
+		"../LiveCalculator/src/EvaluationBudget.h",
+		"../LiveCalculator/src/EvaluationBudget.cpp",
+		"../LiveCalculator/src/EvaluationContext.h",
+		"../LiveCalculator/src/EvaluationContext.cpp",
+		"../LiveCalculator/src/Position.h",
+		"../LiveCalculator/src/Printable.h",
+		"../LiveCalculator/src/Trace.h",
+		"../LiveCalculator/src/Trace.cpp",
+		"../LiveCalculator/src/Lexer/**.h",
+		"../LiveCalculator/src/Lexer/**.cpp",
+		"../LiveCalculator/src/Parser/**.h",
+		"../LiveCalculator/src/Parser/**.cpp",
+		"../LiveCalculator/src/Interpreter/**.h",
+		"../LiveCalculator/src/Interpreter/**.cpp"
+	}
+
+	includedirs
+	{
+		"./src",
+		"../LiveCalculator/src"
+	}
+
+	pchheader "Pch.h"
+	pchsource "../LiveCalculator/src/Pch.cpp"
+
+	targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+	filter "system:linux"
+		links { "pthread" }
+
+	filter "configurations:Debug"
+		defines { "WL_DEBUG" }
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "WL_RELEASE" }
+		runtime "Release"
+		optimize "On"
+		symbols "On"
+
+	filter "configurations:Dist"
+		defines { "WL_DIST" }
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
\ No newline at end of file
@@ -0,0 +1,147 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "EvalServer.h"
+#include "Trace.h"
+
+#include <csignal>
+
+static EvalServer* GServer = nullptr;
+
+static void OnSignal(int)
+{
+	GServer->Stop();
+}
+
+/*
+ * Evaluation daemon for other processes on the same host.
+ * Usage: EvalServer [--unix <path>] [--port <port>] [--workers <count>] [--window <microseconds>] [--batch <count>] [--share 0|1] [--sum strict|pairwise|compensated] [--cache <path>] [--timeout <milliseconds>] [--trace <path>]
+ *
+ * --share 1 evaluates subexpressions repeated across the formulas of a batch once.
+ * --sum adds long '+'/'-' chains as one pairwise or compensated sum, which can change float results in the last digits.
+ * --cache evaluates formulas found in an expression cache without lexing and parsing them. On exit the formulas it
+ *         did not have are added to it, a missing or invalid cache is rebuilt. KernelGenerator writes a first one.
+ * --timeout limits the time one formula may take, see ServerOptions::Limits for the other limits.
+ * --trace writes the recorded trace events as Chrome JSON on exit, only in builds made with "premake5 --tracing".
+ * Listens on /tmp/LiveCalculator.sock when neither --unix nor --port is given.
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	ServerOptions Options;
+	const char* TracePath = nullptr;
+
+	for (int ArgumentIndex = 1; ArgumentIndex < ArgumentCount; ArgumentIndex += 2)
+	{
+		const std::string_view Name = Arguments[ArgumentIndex];
+
+		if (ArgumentIndex + 1 == ArgumentCount)
+		{
+			printf("Missing value for %s\n", Arguments[ArgumentIndex]);
+			return 1;
+		}
+
+		const char* Value = Arguments[ArgumentIndex + 1];
+
+		if (Name == "--unix")
+		{
+			Options.SocketPath = Value;
+		}
+		else if (Name == "--port")
+		{
+			Options.Port = static_cast<uint16_t>(std::atoi(Value));
+		}
+		else if (Name == "--workers")
+		{
+			Options.WorkerCount = static_cast<uint32_t>(std::atoi(Value));
+		}
+		else if (Name == "--window")
+		{
+			Options.BatchWindowMicroseconds = static_cast<uint32_t>(std::atoi(Value));
+		}
+		else if (Name == "--batch")
+		{
+			Options.MaxBatchSize = static_cast<uint32_t>(std::atoi(Value));
+		}
+		else if (Name == "--share")
+		{
+			Options.ShareSubexpressions = std::atoi(Value) != 0;
+		}
+		else if (Name == "--sum")
+		{
+			const std::string_view Mode = Value;
+
+			if (Mode == "pairwise")
+			{
+				Options.SumMode = SUM_MODE_PAIRWISE;
+			}
+			else if (Mode == "compensated")
+			{
+				Options.SumMode = SUM_MODE_COMPENSATED;
+			}
+			else if (Mode != "strict")
+			{
+				printf("Unknown sum mode %s\n", Value);
+				return 1;
+			}
+		}
+		else if (Name == "--cache")
+		{
+			Options.CachePath = Value;
+		}
+		else if (Name == "--timeout")
+		{
+			Options.Limits.MaxDuration = std::chrono::milliseconds(std::atoi(Value));
+		}
+		else if (Name == "--trace")
+		{
+			TracePath = Value;
+		}
+		else
+		{
+			printf("Usage: EvalServer [--unix <path>] [--port <port>] [--workers <count>] [--window <microseconds>] [--batch <count>] [--share 0|1] [--sum strict|pairwise|compensated] [--cache <path>] [--timeout <milliseconds>] [--trace <path>]\n");
+			return 1;
+		}
+	}
+
+	if (Options.SocketPath.empty() && Options.Port == 0)
+	{
+		Options.SocketPath = "/tmp/LiveCalculator.sock";
+	}
+
+	EvalServer Server(Options);
+
+	if (!Server.Start())
+	{
+		return 1;
+	}
+
+	GServer = &Server;
+	std::signal(SIGINT, OnSignal);
+	std::signal(SIGTERM, OnSignal);
+
+	printf("Listening on %s%s%s\n",
+	       Options.SocketPath.c_str(),
+	       !Options.SocketPath.empty() && Options.Port != 0 ? " and " : "",
+	       Options.Port != 0 ? std::format("127.0.0.1:{}", Options.Port).c_str() : "");
+
+	Server.Run();
+
+	if (Options.ShareSubexpressions)
+	{
+		printf("Deduplicated %llu nodes\n", static_cast<unsigned long long>(Server.GetDeduplicatedNodeCount()));
+	}
+
+	if (TracePath != nullptr)
+	{
+#ifdef WL_ENABLE_TRACING
+		if (Trace::WriteJson(TracePath))
+		{
+			printf("Wrote trace to %s\n", TracePath);
+		}
+#else
+		printf("Built without tracing, --trace is ignored\n");
+#endif
+	}
+
+	return 0;
+}
@@ -0,0 +1,756 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "EvalServer.h"
+#include "ErrorManager.h"
+#include "EvaluationContext.h"
+#include "Interpreter/ExpressionDag.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/NumberFormat.h"
+#include "Parser/Parser.h"
+#include "Trace.h"
+
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// epoll data of the fixed handles, connections are numbered from FIRST_CONNECTION_ID
+enum ELoopTag : uint64_t
+{
+	TAG_UNIX_SOCKET,
+	TAG_TCP_SOCKET,
+	TAG_WAKE,
+	TAG_TIMER,
+	FIRST_CONNECTION_ID = 16
+};
+
+// Bounds the memory a stream of distinct formulas can take before the cache is written
+static constexpr size_t MAX_NEW_CACHE_ENTRIES = 1 << 16;
+
+static void PrintError(const char* What)
+{
+	printf("%s: %s\n", What, strerror(errno));
+}
+
+// Text of the first error, or the formatted result
+static Protocol::EStatus GetResponseText(const Number& Result, const ErrorManager& Errors, std::string& OutText)
+{
+	if (const Error* FirstError = Errors.GetFirstError())
+	{
+		OutText = std::format("{}: {}", FirstError->GetName(), FirstError->GetDetails());
+		return Protocol::STATUS_ERROR;
+	}
+
+	char Buffer[NumberFormat::MAX_LENGTH];
+	OutText.assign(Buffer, NumberFormat::Format(Buffer, Buffer + sizeof(Buffer), Result));
+
+	return Protocol::STATUS_OK;
+}
+
+static void CloseHandle(int& Handle)
+{
+	if (Handle >= 0)
+	{
+		close(Handle);
+		Handle = -1;
+	}
+}
+
+EvalServer::EvalServer(ServerOptions InOptions)
+	: Options(std::move(InOptions)),
+	  NextConnectionId(FIRST_CONNECTION_ID)
+{
+	if (Options.WorkerCount == 0)
+	{
+		Options.WorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	Options.MaxBatchSize = std::max(Options.MaxBatchSize, 1u);
+}
+
+EvalServer::~EvalServer()
+{
+	ShutdownToken.Cancel();
+
+	{
+		std::lock_guard Lock(BatchMutex);
+		IsShuttingDown = true;
+	}
+
+	BatchReady.notify_all();
+
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+
+	for (auto& [ConnectionId, Client] : Connections)
+	{
+		close(Client.Socket);
+	}
+
+	if (UnixSocket >= 0)
+	{
+		unlink(Options.SocketPath.c_str());
+	}
+
+	CloseHandle(UnixSocket);
+	CloseHandle(TcpSocket);
+	CloseHandle(WakeHandle);
+	CloseHandle(TimerHandle);
+	CloseHandle(LoopHandle);
+}
+
+bool EvalServer::Start()
+{
+	LoopHandle = epoll_create1(EPOLL_CLOEXEC);
+	WakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	TimerHandle = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+	if (LoopHandle < 0 || WakeHandle < 0 || TimerHandle < 0)
+	{
+		PrintError("Failed to create the event loop");
+		return false;
+	}
+
+	if (Options.SocketPath.empty() && Options.Port == 0)
+	{
+		printf("Neither a socket path nor a port to listen on\n");
+		return false;
+	}
+
+	if (!Options.SocketPath.empty())
+	{
+		UnixSocket = OpenUnixSocket();
+
+		if (UnixSocket < 0 || !AddToLoop(UnixSocket, TAG_UNIX_SOCKET, EPOLLIN))
+		{
+			return false;
+		}
+	}
+
+	if (Options.Port != 0)
+	{
+		TcpSocket = OpenTcpSocket();
+
+		if (TcpSocket < 0 || !AddToLoop(TcpSocket, TAG_TCP_SOCKET, EPOLLIN))
+		{
+			return false;
+		}
+	}
+
+	if (!AddToLoop(WakeHandle, TAG_WAKE, EPOLLIN) || !AddToLoop(TimerHandle, TAG_TIMER, EPOLLIN))
+	{
+		return false;
+	}
+
+	// A stale or corrupt cache is not fatal, every formula then goes through the whole pipeline until Run() rebuilds it
+	if (!Options.CachePath.empty() && !Cache.Open(Options.CachePath))
+	{
+		printf("Rebuilding missing or invalid expression cache %s on exit\n", Options.CachePath.c_str());
+		IsCacheInvalid = true;
+	}
+
+	for (uint32_t WorkerIndex = 0; WorkerIndex < Options.WorkerCount; ++WorkerIndex)
+	{
+		Workers.emplace_back(&EvalServer::WorkerMain, this);
+	}
+
+	IsRunning = true;
+	return true;
+}
+
+void EvalServer::Run()
+{
+	epoll_event Events[64];
+
+	while (IsRunning)
+	{
+		const int EventCount = epoll_wait(LoopHandle, Events, static_cast<int>(std::size(Events)), -1);
+
+		if (EventCount < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			PrintError("epoll_wait failed");
+			break;
+		}
+
+		for (int EventIndex = 0; EventIndex < EventCount; ++EventIndex)
+		{
+			const uint64_t Tag = Events[EventIndex].data.u64;
+			const uint32_t Flags = Events[EventIndex].events;
+
+			switch (Tag)
+			{
+			case TAG_UNIX_SOCKET:
+				AcceptConnections(UnixSocket);
+				break;
+
+			case TAG_TCP_SOCKET:
+				AcceptConnections(TcpSocket);
+				break;
+
+			case TAG_WAKE:
+				DeliverResponses();
+				break;
+
+			case TAG_TIMER:
+				{
+					uint64_t Expirations;
+					(void)read(TimerHandle, &Expirations, sizeof(Expirations));
+					DispatchBatch();
+				}
+				break;
+
+			default:
+				if (Flags & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				{
+					ReadConnection(Tag);
+				}
+
+				if (Flags & EPOLLOUT)
+				{
+					FlushConnection(Tag);
+				}
+
+				break;
+			}
+		}
+	}
+
+	SaveCache();
+}
+
+void EvalServer::Stop()
+{
+	IsRunning = false;
+	ShutdownToken.Cancel();
+
+	const uint64_t One = 1;
+	(void)write(WakeHandle, &One, sizeof(One));
+}
+
+[[nodiscard]] int EvalServer::OpenUnixSocket() const
+{
+	sockaddr_un Address = {};
+	Address.sun_family = AF_UNIX;
+
+	if (Options.SocketPath.size() >= sizeof(Address.sun_path))
+	{
+		printf("Socket path %s is too long\n", Options.SocketPath.c_str());
+		return -1;
+	}
+
+	std::copy(Options.SocketPath.begin(), Options.SocketPath.end(), Address.sun_path);
+
+	const int Socket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (Socket < 0)
+	{
+		PrintError("Failed to create the unix socket");
+		return -1;
+	}
+
+	// A socket file left behind by an earlier run would make bind fail
+	unlink(Options.SocketPath.c_str());
+
+	if (bind(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) < 0 || listen(Socket, SOMAXCONN) < 0)
+	{
+		PrintError(Options.SocketPath.c_str());
+		close(Socket);
+		return -1;
+	}
+
+	return Socket;
+}
+
+[[nodiscard]] int EvalServer::OpenTcpSocket() const
+{
+	const int Socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (Socket < 0)
+	{
+		PrintError("Failed to create the tcp socket");
+		return -1;
+	}
+
+	const int Enable = 1;
+	setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, &Enable, sizeof(Enable));
+
+	// Local processes only
+	sockaddr_in Address = {};
+	Address.sin_family = AF_INET;
+	Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	Address.sin_port = htons(Options.Port);
+
+	if (bind(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) < 0 || listen(Socket, SOMAXCONN) < 0)
+	{
+		PrintError(std::format("127.0.0.1:{}", Options.Port).c_str());
+		close(Socket);
+		return -1;
+	}
+
+	return Socket;
+}
+
+bool EvalServer::AddToLoop(const int Socket, const uint64_t Tag, const uint32_t Events) const
+{
+	epoll_event Event = {};
+	Event.events = Events;
+	Event.data.u64 = Tag;
+
+	if (epoll_ctl(LoopHandle, EPOLL_CTL_ADD, Socket, &Event) < 0)
+	{
+		PrintError("epoll_ctl failed");
+		return false;
+	}
+
+	return true;
+}
+
+void EvalServer::AcceptConnections(const int ListenSocket)
+{
+	while (true)
+	{
+		const int Socket = accept4(ListenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (Socket < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				PrintError("accept failed");
+			}
+
+			return;
+		}
+
+		if (ListenSocket == TcpSocket)
+		{
+			// Responses are small, do not hold them back
+			const int Enable = 1;
+			setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &Enable, sizeof(Enable));
+		}
+
+		const uint64_t ConnectionId = NextConnectionId++;
+
+		if (!AddToLoop(Socket, ConnectionId, EPOLLIN))
+		{
+			close(Socket);
+			continue;
+		}
+
+		Connections.try_emplace(ConnectionId, Socket);
+	}
+}
+
+void EvalServer::ReadConnection(const uint64_t ConnectionId)
+{
+	const auto Found = Connections.find(ConnectionId);
+
+	if (Found == Connections.end())
+	{
+		return;
+	}
+
+	Connection& Client = Found->second;
+	char Chunk[16384];
+
+	while (true)
+	{
+		const ssize_t Count = recv(Client.Socket, Chunk, sizeof(Chunk), 0);
+
+		if (Count > 0)
+		{
+			Client.ReadBuffer.insert(Client.ReadBuffer.end(), Chunk, Chunk + Count);
+			continue;
+		}
+
+		if (Count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (Count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+
+		// Closed by the client or failed, responses still on the way are dropped
+		CloseConnection(ConnectionId);
+		return;
+	}
+
+	size_t Offset = 0;
+
+	while (Client.ReadBuffer.size() - Offset >= sizeof(Protocol::RequestHeader))
+	{
+		Protocol::RequestHeader Header;
+		std::memcpy(&Header, Client.ReadBuffer.data() + Offset, sizeof(Header));
+
+		if (Header.Length > Protocol::MAX_PAYLOAD_LENGTH)
+		{
+			CloseConnection(ConnectionId);
+			return;
+		}
+
+		if (Client.ReadBuffer.size() - Offset - sizeof(Header) < Header.Length)
+		{
+			break;
+		}
+
+		const char* Payload = Client.ReadBuffer.data() + Offset + sizeof(Header);
+		QueueRequest({ ConnectionId, Header.Id, std::string(Payload, Header.Length) });
+
+		Offset += sizeof(Header) + Header.Length;
+	}
+
+	Client.ReadBuffer.erase(Client.ReadBuffer.begin(), Client.ReadBuffer.begin() + static_cast<ptrdiff_t>(Offset));
+}
+
+void EvalServer::FlushConnection(const uint64_t ConnectionId)
+{
+	const auto Found = Connections.find(ConnectionId);
+
+	if (Found == Connections.end())
+	{
+		return;
+	}
+
+	Connection& Client = Found->second;
+
+	while (Client.WriteOffset < Client.WriteBuffer.size())
+	{
+		const ssize_t Count = send(Client.Socket, Client.WriteBuffer.data() + Client.WriteOffset, Client.WriteBuffer.size() - Client.WriteOffset, MSG_NOSIGNAL);
+
+		if (Count >= 0)
+		{
+			Client.WriteOffset += static_cast<size_t>(Count);
+			continue;
+		}
+
+		if (errno == EINTR)
+		{
+			continue;
+		}
+
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			// Finish once the socket is writable again
+			if (!Client.IsWaitingForWrite)
+			{
+				epoll_event Event = {};
+				Event.events = EPOLLIN | EPOLLOUT;
+				Event.data.u64 = ConnectionId;
+				epoll_ctl(LoopHandle, EPOLL_CTL_MOD, Client.Socket, &Event);
+				Client.IsWaitingForWrite = true;
+			}
+
+			return;
+		}
+
+		CloseConnection(ConnectionId);
+		return;
+	}
+
+	Client.WriteBuffer.clear();
+	Client.WriteOffset = 0;
+
+	if (Client.IsWaitingForWrite)
+	{
+		epoll_event Event = {};
+		Event.events = EPOLLIN;
+		Event.data.u64 = ConnectionId;
+		epoll_ctl(LoopHandle, EPOLL_CTL_MOD, Client.Socket, &Event);
+		Client.IsWaitingForWrite = false;
+	}
+}
+
+void EvalServer::CloseConnection(const uint64_t ConnectionId)
+{
+	const auto Found = Connections.find(ConnectionId);
+
+	if (Found != Connections.end())
+	{
+		// Closing also removes the socket from the epoll set
+		close(Found->second.Socket);
+		Connections.erase(Found);
+	}
+}
+
+void EvalServer::QueueRequest(Request&& NewRequest)
+{
+	PendingBatch.push_back(std::move(NewRequest));
+
+	if (PendingBatch.size() >= Options.MaxBatchSize || Options.BatchWindowMicroseconds == 0)
+	{
+		DispatchBatch();
+	}
+	else if (PendingBatch.size() == 1)
+	{
+		// The window starts with the first request of a batch
+		itimerspec Timer = {};
+		Timer.it_value.tv_sec = Options.BatchWindowMicroseconds / 1000000;
+		Timer.it_value.tv_nsec = static_cast<long>(Options.BatchWindowMicroseconds % 1000000) * 1000;
+		timerfd_settime(TimerHandle, 0, &Timer, nullptr);
+	}
+}
+
+void EvalServer::DispatchBatch()
+{
+	if (PendingBatch.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard Lock(BatchMutex);
+		Batches.push_back(std::move(PendingBatch));
+	}
+
+	BatchReady.notify_one();
+
+	PendingBatch.clear();
+	PendingBatch.reserve(Options.MaxBatchSize);
+
+	// Disarm, a timer that already fired finds an empty batch
+	const itimerspec Timer = {};
+	timerfd_settime(TimerHandle, 0, &Timer, nullptr);
+}
+
+void EvalServer::DeliverResponses()
+{
+	uint64_t WakeCount;
+	(void)read(WakeHandle, &WakeCount, sizeof(WakeCount));
+
+	std::vector<Response> Delivered;
+
+	{
+		std::lock_guard Lock(ResponseMutex);
+		Delivered.swap(Responses);
+	}
+
+	// Write each connection once, after all of its responses are appended
+	std::vector<uint64_t> Pending;
+
+	for (const Response& Current : Delivered)
+	{
+		const auto Found = Connections.find(Current.ConnectionId);
+
+		if (Found == Connections.end())
+		{
+			continue;
+		}
+
+		Connection& Client = Found->second;
+
+		if (Client.WriteBuffer.empty() && !Client.IsWaitingForWrite)
+		{
+			Pending.push_back(Current.ConnectionId);
+		}
+
+		Protocol::ResponseHeader Header = {};
+		Header.Length = static_cast<uint32_t>(Current.Text.size());
+		Header.Id = Current.Id;
+		Header.Status = Current.Status;
+
+		const char* HeaderBytes = reinterpret_cast<const char*>(&Header);
+		Client.WriteBuffer.insert(Client.WriteBuffer.end(), HeaderBytes, HeaderBytes + sizeof(Header));
+		Client.WriteBuffer.insert(Client.WriteBuffer.end(), Current.Text.begin(), Current.Text.end());
+	}
+
+	for (const uint64_t ConnectionId : Pending)
+	{
+		FlushConnection(ConnectionId);
+	}
+}
+
+void EvalServer::WorkerMain()
+{
+	// Reused for every request this worker evaluates, evaluating stops allocating once these have grown
+	EvaluationContext Context(Options.Limits, &ShutdownToken);
+	Context.SetSumMode(Options.SumMode);
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	ExpressionDag Dag;
+	Interpreter::SumScratch Scratch;
+	std::vector<Response> Finished;
+
+	while (true)
+	{
+		std::vector<Request> Batch;
+
+		{
+			std::unique_lock Lock(BatchMutex);
+			BatchReady.wait(Lock, [this]() { return IsShuttingDown || !Batches.empty(); });
+
+			if (Batches.empty())
+			{
+				return;
+			}
+
+			Batch = std::move(Batches.front());
+			Batches.pop_front();
+		}
+
+		WL_TRACE_SCOPE("Batch", Batch.size());
+
+		if (Options.ShareSubexpressions)
+		{
+			EvaluateShared(Batch, Finished, Errors, Tree, Dag);
+		}
+		else
+		{
+			for (const Request& Current : Batch)
+			{
+				WL_TRACE_EXPRESSION(Current.Id);
+
+				Response& Result = Finished.emplace_back();
+				Result.ConnectionId = Current.ConnectionId;
+				Result.Id = Current.Id;
+				uint32_t CachedRoot;
+
+				if (Cache.Find(Current.Text, CachedRoot))
+				{
+					Errors.Clear();
+					EvaluationBudget Budget(Options.Limits, &ShutdownToken);
+					const Number Value = Interpreter::Visit(Cache.GetTree(), CachedRoot, Errors, Options.SumMode, Scratch, &Budget);
+					Result.Status = GetResponseText(Value, Errors, Result.Text);
+				}
+				else
+				{
+					const Number Value = Context.Evaluate(Current.Text);
+					Result.Status = GetResponseText(Value, Context.GetErrors(), Result.Text);
+
+					if (Result.Status == Protocol::STATUS_OK && !Options.CachePath.empty())
+					{
+						AddToCache(Current.Text);
+					}
+				}
+			}
+		}
+
+		{
+			std::lock_guard Lock(ResponseMutex);
+			Responses.insert(Responses.end(), std::make_move_iterator(Finished.begin()), std::make_move_iterator(Finished.end()));
+		}
+
+		Finished.clear();
+
+		const uint64_t One = 1;
+		(void)write(WakeHandle, &One, sizeof(One));
+	}
+}
+
+void EvalServer::AddToCache(const std::string& Formula)
+{
+	std::lock_guard Lock(NewFormulaMutex);
+
+	if (NewFormulas.size() < MAX_NEW_CACHE_ENTRIES)
+	{
+		NewFormulas.insert(Formula);
+	}
+}
+
+void EvalServer::SaveCache()
+{
+	std::lock_guard Lock(NewFormulaMutex);
+
+	if (Options.CachePath.empty() || (NewFormulas.empty() && !IsCacheInvalid))
+	{
+		return;
+	}
+
+	// The new file keeps every expression of the old one, Write() replaces the file the mapping still points to
+	ExpressionCacheWriter Writer;
+	ErrorManager Errors;
+
+	for (uint32_t EntryIndex = 0; EntryIndex < Cache.GetEntryCount(); ++EntryIndex)
+	{
+		(void)Writer.Add(Cache.GetSource(EntryIndex), Errors);
+	}
+
+	uint32_t AddedCount = 0;
+
+	for (const std::string& Formula : NewFormulas)
+	{
+		AddedCount += Writer.Add(Formula, Errors) ? 1 : 0;
+	}
+
+	if (Writer.Write(Options.CachePath))
+	{
+		printf("Added %u formulas to the expression cache %s\n", AddedCount, Options.CachePath.c_str());
+		NewFormulas.clear();
+		IsCacheInvalid = false;
+	}
+	else
+	{
+		printf("Failed to write the expression cache %s\n", Options.CachePath.c_str());
+	}
+}
+
+void EvalServer::EvaluateShared(const std::vector<Request>& Batch, std::vector<Response>& OutResponses, ErrorManager& Errors, SyntaxTree& Tree, ExpressionDag& Dag)
+{
+	Tree.Clear();
+	Dag.Clear();
+
+	const size_t FirstResponse = OutResponses.size();
+
+	// Every formula of the batch goes into the same pool, the ones that parsed are shared in the DAG.
+	// INVALID_NODE marks a formula that already has its error response.
+	std::vector<uint32_t> Expressions;
+	Expressions.reserve(Batch.size());
+
+	for (const Request& Current : Batch)
+	{
+		WL_TRACE_EXPRESSION(Current.Id);
+
+		Response& Result = OutResponses.emplace_back();
+		Result.ConnectionId = Current.ConnectionId;
+		Result.Id = Current.Id;
+
+		Errors.Clear();
+		EvaluationBudget Budget(Options.Limits, &ShutdownToken);
+		const uint32_t Root = Parser::GetExpressionResult(Current.Text, Tree, Errors, &Budget);
+
+		if (Errors.HasErrors())
+		{
+			Result.Status = GetResponseText(Number(), Errors, Result.Text);
+			Expressions.push_back(INVALID_NODE);
+		}
+		else
+		{
+			Expressions.push_back(Dag.AddExpression(Tree, Root));
+		}
+	}
+
+	Dag.Evaluate();
+
+	for (size_t RequestIndex = 0; RequestIndex < Batch.size(); ++RequestIndex)
+	{
+		if (Expressions[RequestIndex] != INVALID_NODE)
+		{
+			Response& Result = OutResponses[FirstResponse + RequestIndex];
+
+			Errors.Clear();
+			const Number Value = Dag.GetResult(Tree, Expressions[RequestIndex], Errors);
+			Result.Status = GetResponseText(Value, Errors, Result.Text);
+		}
+	}
+
+	DeduplicatedNodeCount += Dag.GetDeduplicatedCount();
+}
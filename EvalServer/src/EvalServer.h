@@ -0,0 +1,164 @@
+﻿#pragma once
+
+#include "Protocol.h"
+#include "EvaluationBudget.h"
+#include "Cache/ExpressionCache.h"
+#include "Interpreter/Summation.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+class ExpressionDag;
+class SyntaxTree;
+
+struct ServerOptions
+{
+	// Unix domain socket to listen on, empty to disable
+	std::string SocketPath;
+
+	// TCP port on 127.0.0.1, 0 to disable
+	uint16_t Port = 0;
+
+	// 0 uses std::thread::hardware_concurrency()
+	uint32_t WorkerCount = 0;
+
+	// A batch is handed to the workers once it has MaxBatchSize requests or its first request is this old
+	uint32_t BatchWindowMicroseconds = 200;
+	uint32_t MaxBatchSize = 256;
+
+	// Parse each batch into one pool and evaluate subexpressions repeated across its formulas once (ExpressionDag)
+	bool ShareSubexpressions = false;
+
+	// How long '+'/'-' chains are added, see Interpreter::Visit. Shared batches always add left to right.
+	ESumMode SumMode = SUM_MODE_STRICT;
+
+	// Expression cache, formulas found in it are evaluated without lexing and parsing. Formulas that were not found
+	// are added to it once Run() returns, a missing, stale or corrupt file is rebuilt then.
+	std::string CachePath;
+
+	// Applied to every request, so a single formula cannot hold up or overflow the stack of a worker
+	EvaluationLimits Limits = {
+		.MaxInputLength = Protocol::MAX_PAYLOAD_LENGTH,
+		.MaxNodeCount = 1 << 15,
+		.MaxDepth = 1024,
+		.MaxDuration = std::chrono::milliseconds(100)
+	};
+};
+
+/*
+ * Headless evaluation daemon for Linux. A single thread runs an epoll loop that accepts connections, reads request
+ * frames (see Protocol.h) and writes responses. Requests from all connections are collected into one batch until
+ * the batch window expires or the batch is full, the batch is then evaluated by a worker from the pool. Workers
+ * hand their responses back through an eventfd.
+ */
+class EvalServer
+{
+public:
+	explicit EvalServer(ServerOptions InOptions);
+	~EvalServer();
+
+	EvalServer(const EvalServer&) = delete;
+	EvalServer& operator=(const EvalServer&) = delete;
+
+	// Opens the listening sockets and starts the workers, prints the reason and returns false on failure
+	bool Start();
+
+	// Runs the event loop until Stop() is called, then writes the formulas missing from the expression cache to it
+	void Run();
+
+	// Safe to call from any thread or a signal handler
+	void Stop();
+
+	// Nodes shared instead of evaluated again, only counted with ShareSubexpressions
+	[[nodiscard]] uint64_t GetDeduplicatedNodeCount() const { return DeduplicatedNodeCount; }
+
+	// Protected fields and functions
+protected:
+	struct Request
+	{
+		uint64_t ConnectionId;
+		uint32_t Id;
+		std::string Text;
+	};
+
+	struct Response
+	{
+		uint64_t ConnectionId;
+		uint32_t Id;
+		Protocol::EStatus Status;
+		std::string Text;
+	};
+
+	struct Connection
+	{
+		explicit Connection(const int Socket)
+			: Socket(Socket)
+		{
+		}
+
+		int Socket;
+		std::vector<char> ReadBuffer;
+		std::vector<char> WriteBuffer;
+		size_t WriteOffset = 0;
+		bool IsWaitingForWrite = false;
+	};
+
+	[[nodiscard]] int OpenUnixSocket() const;
+	[[nodiscard]] int OpenTcpSocket() const;
+	bool AddToLoop(int Socket, uint64_t Tag, uint32_t Events) const;
+
+	void AcceptConnections(int ListenSocket);
+	void ReadConnection(uint64_t ConnectionId);
+	void FlushConnection(uint64_t ConnectionId);
+	void CloseConnection(uint64_t ConnectionId);
+
+	void QueueRequest(Request&& NewRequest);
+	void DispatchBatch();
+	void DeliverResponses();
+
+	void WorkerMain();
+	void AddToCache(const std::string& Formula);
+	void SaveCache();
+	void EvaluateShared(const std::vector<Request>& Batch, std::vector<Response>& OutResponses, ErrorManager& Errors, SyntaxTree& Tree, ExpressionDag& Dag);
+
+	ServerOptions Options;
+
+	int LoopHandle = -1;
+	int UnixSocket = -1;
+	int TcpSocket = -1;
+	int WakeHandle = -1;
+	int TimerHandle = -1;
+	std::atomic<bool> IsRunning = false;
+
+	// Event loop only
+	std::unordered_map<uint64_t, Connection> Connections;
+	uint64_t NextConnectionId;
+	std::vector<Request> PendingBatch;
+
+	// Shared with the workers
+	std::mutex BatchMutex;
+	std::condition_variable BatchReady;
+	std::deque<std::vector<Request>> Batches;
+	bool IsShuttingDown = false;
+
+	// Stops evaluations that are still running when the server shuts down
+	CancelToken ShutdownToken;
+
+	std::mutex ResponseMutex;
+	std::vector<Response> Responses;
+
+	std::atomic<uint64_t> DeduplicatedNodeCount = 0;
+
+	// Read only once the workers run
+	ExpressionCache Cache;
+
+	// Formulas evaluated without errors that the cache did not have, at most MAX_NEW_CACHE_ENTRIES
+	std::mutex NewFormulaMutex;
+	std::unordered_set<std::string> NewFormulas;
+	bool IsCacheInvalid = false;
+
+	std::vector<std::thread> Workers;
+};
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+/*
+ * Wire format of the evaluation server. Every frame is a fixed header followed by Length bytes of text, all
+ * integers are little-endian. Responses carry the Id of their request, so a client may send any number of
+ * requests on one connection before reading, responses can arrive in a different order.
+ *
+ *		Request  - RequestHeader, then the formula
+ *		Response - ResponseHeader, then the formatted result, or "Name: details" of the first error
+ */
+namespace Protocol
+{
+	enum EStatus : uint8_t
+	{
+		STATUS_OK,
+		STATUS_ERROR
+	};
+
+	// Longer requests close the connection
+	inline constexpr uint32_t MAX_PAYLOAD_LENGTH = 1u << 20;
+
+	struct RequestHeader
+	{
+		uint32_t Length;
+		uint32_t Id;
+	};
+
+	struct ResponseHeader
+	{
+		uint32_t Length;
+		uint32_t Id;
+		EStatus Status;
+		uint8_t Reserved[3];
+	};
+
+	static_assert(sizeof(RequestHeader) == 8);
+	static_assert(sizeof(ResponseHeader) == 12);
+	static_assert(std::endian::native == std::endian::little, "Headers are sent as they are laid out in memory");
+}
@@ -0,0 +1,75 @@
+-- One fuzz target per pipeline stage plus a differential target, all under ASan and UBSan.
+-- "premake5 --cc=clang gmake2" links them against libFuzzer, with GCC they get ReplayMain.cpp and run the files
+-- given on the command line, which is also how AFL++ drives them (CC=afl-clang-fast with --cc=clang works too).
+local function FuzzProject(Name)
+	project(Name)
+		kind "ConsoleApp"
+		language "C++"
+		cppdialect "C++20"
+		staticruntime "off"
+
+		files
+		{
+			"src/Fuzz.h",
+			"src/Fuzz.cpp",
+			"src/ReplayMain.cpp",
+			"src/" .. Name .. ".cpp",
+			"../LiveCalculator/src/**.h",
+			"../LiveCalculator/src/**.cpp"
+		}
+
+		removefiles
+		{
+			"../LiveCalculator/src/EntryPoint.cpp",
+			"../LiveCalculator/src/UI.h",
+			"../LiveCalculator/src/UI.cpp"
+		}
+
+		includedirs
+		{
+			"./src",
+			"../LiveCalculator/src",
+			"../vendor/imgui"
+		}
+
+		pchheader "Pch.h"
+		pchsource "../LiveCalculator/src/Pch.cpp"
+
+		targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+		objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+		links { "pthread" }
+
+		filter "toolset:clang"
+			removefiles { "src/ReplayMain.cpp" }
+			buildoptions { "-fsanitize=fuzzer,address,undefined", "-fno-sanitize-recover=undefined" }
+			linkoptions { "-fsanitize=fuzzer,address,undefined" }
+
+		filter "toolset:gcc"
+			buildoptions { "-fsanitize=address,undefined", "-fno-sanitize-recover=undefined" }
+			linkoptions { "-fsanitize=address,undefined" }
+
+		filter "configurations:Debug"
+			defines { "WL_DEBUG" }
+			runtime "Debug"
+			symbols "On"
+
+		filter "configurations:Release"
+			defines { "WL_RELEASE" }
+			runtime "Release"
+			optimize "On"
+			symbols "On"
+
+		filter "configurations:Dist"
+			defines { "WL_DIST" }
+			runtime "Release"
+			optimize "On"
+			symbols "On"
+
+		filter {}
+end
+
+FuzzProject "FuzzLexer"
+FuzzProject "FuzzParser"
+FuzzProject "FuzzInterpreter"
+FuzzProject "FuzzDifferential"
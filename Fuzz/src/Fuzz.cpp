@@ -0,0 +1,11 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+void Fuzz::ReportFailure(const char* File, const int32_t Line, const char* Condition)
+{
+	printf("%s(%d): check failed: %s\n", File, Line, Condition);
+	fflush(stdout);
+	std::abort();
+}
@@ -0,0 +1,25 @@
+﻿#pragma once
+
+/*
+ * Shared parts of the fuzz targets. Every target is one LLVMFuzzerTestOneInput in its own translation unit, libFuzzer
+ * or AFL++ provides main() with clang, ReplayMain.cpp runs saved inputs through the same function with GCC.
+ * A failed WL_FUZZ_CHECK aborts so the fuzzer keeps the input that caused it.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size);
+
+namespace Fuzz
+{
+	// Longer inputs are skipped, the recursive interpreters descend one level per operator
+	inline constexpr size_t MAX_INPUT_LENGTH = 4096;
+
+	[[noreturn]] void ReportFailure(const char* File, int32_t Line, const char* Condition);
+}
+
+#define WL_FUZZ_CHECK(Condition) \
+	do \
+	{ \
+		if (!(Condition)) \
+		{ \
+			Fuzz::ReportFailure(__FILE__, __LINE__, #Condition); \
+		} \
+	} while (false)
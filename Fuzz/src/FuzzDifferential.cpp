@@ -0,0 +1,202 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+#include "Cache/ExpressionCache.h"
+#include "ErrorManager.h"
+#include "EvaluationContext.h"
+#include "Interpreter/DirectEvaluator.h"
+#include "Interpreter/ExpressionDag.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/ParallelInterpreter.h"
+#include "Interpreter/RationalInterpreter.h"
+#include "Jit/Jit.h"
+#include "Lexer/Lexer.h"
+#include "Lexer/ParallelLexer.h"
+#include "Parser/Parser.h"
+
+#include <filesystem>
+#include <unistd.h>
+
+static bool IsSameToken(const Token& First, const Token& Second)
+{
+	return First.Type == Second.Type
+		&& First.Value.data() == Second.Value.data()
+		&& First.Value.size() == Second.Value.size()
+		&& First.Literal.IsIdenticalTo(Second.Literal)
+		&& First.Start.Index == Second.Start.Index
+		&& First.End.Index == Second.End.Index;
+}
+
+// One file per process, parallel fuzzing jobs would otherwise replace each other's cache between Write and Open
+static const std::string& GetCachePath()
+{
+	static const std::string Path = (std::filesystem::temp_directory_path() / std::format("LiveCalculatorFuzz.{}.cache", getpid())).string();
+	return Path;
+}
+
+/*
+ * Interpreter::Visit is checked against RationalInterpreter, which shares none of its arithmetic: integer results
+ * wrap, so they have to equal the exact value modulo 2^64. Every other backend has to give the same result and the
+ * same errors as Interpreter::Visit:
+ *
+ *		ParallelLexer       - chunks small enough to cut every input, same tokens and the same first error
+ *		DirectEvaluator     - whatever TryEvaluate accepts has to parse cleanly and evaluate to the same bits
+ *		ParallelInterpreter - thresholds small enough to split every tree, partial trees included. Float chains
+ *		                      reassociated on request only have to keep integer results.
+ *		EvaluationContext   - the same bits when adding strictly, integer results in the other sum modes
+ *		ExpressionDag       - the expression on its own and next to a copy of itself, so every node is shared
+ *		ExpressionCache     - the tree written to a file, mapped and evaluated in place
+ *		Jit                 - compiled code that runs to the end, Jit::Evaluate with its fallback always
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, const size_t Size)
+{
+	if (Size > Fuzz::MAX_INPUT_LENGTH)
+	{
+		return 0;
+	}
+
+	const std::string_view Input(reinterpret_cast<const char*>(Data), Size);
+
+	ErrorManager LexerErrors;
+	ErrorManager ParallelLexerErrors;
+	const std::pmr::vector<Token> Tokens = Lexer::GetTokens(Input, LexerErrors);
+	const std::pmr::vector<Token> ParallelTokens = ParallelLexer::GetTokens(Input, ParallelLexerErrors, 3, std::pmr::get_default_resource(), 1 + Size % 16);
+
+	WL_FUZZ_CHECK(Tokens.size() == ParallelTokens.size());
+	WL_FUZZ_CHECK(std::equal(Tokens.begin(), Tokens.end(), ParallelTokens.begin(), ParallelTokens.end(), IsSameToken));
+	WL_FUZZ_CHECK(LexerErrors.HasErrors() == ParallelLexerErrors.HasErrors());
+
+	if (LexerErrors.HasErrors() && ParallelLexerErrors.HasErrors())
+	{
+		WL_FUZZ_CHECK(LexerErrors.GetErrors()[0].Start == ParallelLexerErrors.GetErrors()[0].Start);
+		WL_FUZZ_CHECK(LexerErrors.GetErrors()[0].Code == ParallelLexerErrors.GetErrors()[0].Code);
+	}
+
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Input, Tree, Errors);
+	const bool HasSyntaxErrors = Errors.HasErrors();
+
+	Number Direct;
+	ErrorManager DirectErrors;
+	const bool IsDirect = DirectEvaluator::TryEvaluate(Input, Direct, DirectErrors);
+
+	WL_FUZZ_CHECK(!IsDirect || !HasSyntaxErrors);
+
+	if (Tree.GetNode(Root).Type == NODE_TYPE_ERROR)
+	{
+		WL_FUZZ_CHECK(!IsDirect);
+		return 0;
+	}
+
+	ErrorManager ExpectedErrors;
+	const Number Expected = Interpreter::Visit(Tree, Root, ExpectedErrors);
+
+	WL_FUZZ_CHECK(!IsDirect || (!ExpectedErrors.HasErrors() && Direct.IsIdenticalTo(Expected)));
+
+	// Integer results never divide, so the exact value is an integer and no error is possible. The budget only
+	// keeps inputs that multiply thousands of digits together from slowing the fuzzer down.
+	if (Expected.IsInt && !ExpectedErrors.HasErrors())
+	{
+		EvaluationLimits Limits;
+		Limits.MaxOperationCount = 1 << 16;
+
+		EvaluationBudget ExactBudget(Limits);
+		ErrorManager ExactErrors;
+		const std::optional<Rational> Exact = RationalInterpreter::Visit(Tree, Root, ExactErrors, &ExactBudget, Input);
+
+		if (!ExactBudget.IsExhausted())
+		{
+			const BigInt HalfModulus(int64_t{ 1 } << 32);
+			const Rational Modulus(HalfModulus.MultipliedBy(HalfModulus), BigInt(int64_t{ 1 }));
+
+			WL_FUZZ_CHECK(Exact && !ExactErrors.HasErrors());
+			WL_FUZZ_CHECK(Exact->SubtractedBy(Rational(Expected.IntValue)).DividedBy(Modulus).IsInteger());
+		}
+	}
+
+	for (const bool ReassociateFloats : { false, true })
+	{
+		ParallelOptions Options;
+		Options.SequentialThreshold = 1 + static_cast<uint32_t>(Size % 4);
+		Options.ThreadCount = 2;
+		Options.ReassociateIntegers = Size % 2 == 0;
+		Options.ReassociateFloats = ReassociateFloats;
+
+		ErrorManager ParallelErrors;
+		const Number Parallel = ParallelInterpreter::Visit(Tree, Root, ParallelErrors, Options);
+
+		WL_FUZZ_CHECK(ParallelErrors.HasErrors() == ExpectedErrors.HasErrors());
+		WL_FUZZ_CHECK(ExpectedErrors.HasErrors() || Parallel.IsIdenticalTo(Expected) || (ReassociateFloats && !Expected.IsInt));
+
+		if (ExpectedErrors.HasErrors() && ParallelErrors.HasErrors())
+		{
+			WL_FUZZ_CHECK(ParallelErrors.GetErrors()[0].Start == ExpectedErrors.GetErrors()[0].Start);
+			WL_FUZZ_CHECK(ParallelErrors.GetErrors()[0].End == ExpectedErrors.GetErrors()[0].End);
+		}
+	}
+
+	// The context, the DAG, the cache and the JIT only see well formed input
+	if (HasSyntaxErrors)
+	{
+		return 0;
+	}
+
+	for (const ESumMode SumMode : { SUM_MODE_STRICT, SUM_MODE_PAIRWISE, SUM_MODE_COMPENSATED })
+	{
+		EvaluationContext Context;
+		Context.SetSumMode(SumMode);
+		const Number Summed = Context.Evaluate(Input);
+
+		WL_FUZZ_CHECK(Context.GetErrors().HasErrors() == ExpectedErrors.HasErrors());
+		WL_FUZZ_CHECK(ExpectedErrors.HasErrors() || Summed.IsIdenticalTo(Expected) || (SumMode != SUM_MODE_STRICT && !Expected.IsInt));
+	}
+
+	ExpressionDag Dag;
+	const uint32_t Expression = Dag.AddExpression(Tree, Root);
+	const uint32_t Copy = Dag.AddExpression(Tree, Root);
+	Dag.Evaluate();
+
+	for (const uint32_t Added : { Expression, Copy })
+	{
+		ErrorManager DagErrors;
+		const Number Shared = Dag.GetResult(Tree, Added, DagErrors);
+
+		WL_FUZZ_CHECK(DagErrors.HasErrors() == ExpectedErrors.HasErrors());
+		WL_FUZZ_CHECK(ExpectedErrors.HasErrors() || Shared.IsIdenticalTo(Expected));
+	}
+
+	ExpressionCacheWriter CacheWriter;
+	ErrorManager CacheErrors;
+	WL_FUZZ_CHECK(CacheWriter.Add(Input, CacheErrors));
+	WL_FUZZ_CHECK(CacheWriter.Write(GetCachePath()));
+
+	ExpressionCache Cache;
+	uint32_t CachedRoot = 0;
+	WL_FUZZ_CHECK(Cache.Open(GetCachePath()));
+	WL_FUZZ_CHECK(Cache.Find(Input, CachedRoot));
+
+	const Number Cached = Interpreter::Visit(Cache.GetTree(), CachedRoot, CacheErrors);
+
+	WL_FUZZ_CHECK(CacheErrors.HasErrors() == ExpectedErrors.HasErrors());
+	WL_FUZZ_CHECK(ExpectedErrors.HasErrors() || Cached.IsIdenticalTo(Expected));
+
+	const std::unique_ptr<CompiledExpression> Compiled = Jit::Compile(Tree, Root);
+	Number Native;
+
+	if (Compiled != nullptr && Compiled->Run(Native))
+	{
+		WL_FUZZ_CHECK(!ExpectedErrors.HasErrors());
+		WL_FUZZ_CHECK(Native.IsIdenticalTo(Expected));
+	}
+
+	ErrorManager JitErrors;
+	Native = Jit::Evaluate(Compiled.get(), Tree, Root, JitErrors);
+
+	WL_FUZZ_CHECK(JitErrors.HasErrors() == ExpectedErrors.HasErrors());
+	WL_FUZZ_CHECK(ExpectedErrors.HasErrors() || Native.IsIdenticalTo(Expected));
+
+	return 0;
+}
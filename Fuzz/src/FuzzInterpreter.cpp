@@ -0,0 +1,61 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+#include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Interpreter/EvaluationProfile.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/RationalInterpreter.h"
+#include "Parser/Parser.h"
+
+// Every way the UI and the server evaluate a tree, partial trees included, under a budget so exact mode terminates
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, const size_t Size)
+{
+	if (Size > Fuzz::MAX_INPUT_LENGTH)
+	{
+		return 0;
+	}
+
+	const std::string_view Input(reinterpret_cast<const char*>(Data), Size);
+
+	EvaluationLimits Limits;
+	Limits.MaxOperationCount = 1 << 16;
+
+	EvaluationBudget ParseBudget(Limits);
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Input, Tree, Errors, &ParseBudget);
+
+	if (Tree.GetNode(Root).Type == NODE_TYPE_ERROR || ParseBudget.IsExhausted())
+	{
+		return 0;
+	}
+
+	for (const ESumMode SumMode : { SUM_MODE_STRICT, SUM_MODE_PAIRWISE, SUM_MODE_COMPENSATED })
+	{
+		EvaluationBudget Budget(Limits);
+		ErrorManager RuntimeErrors;
+		(void)Interpreter::Visit(Tree, Root, RuntimeErrors, SumMode, &Budget);
+	}
+
+	EvaluationBudget ProfileBudget(Limits);
+	ErrorManager ProfileErrors;
+	EvaluationProfile Profile;
+	(void)Interpreter::Visit(Tree, Root, ProfileErrors, Profile, &ProfileBudget);
+
+	std::pmr::string Report;
+	Profile.AppendHeatmap(Report, Tree, Root, Input);
+
+	EvaluationBudget ExactBudget(Limits);
+	ErrorManager ExactErrors;
+
+	if (const std::optional<Rational> Exact = RationalInterpreter::Visit(Tree, Root, ExactErrors, &ExactBudget, Input))
+	{
+		(void)Exact->ToLongDouble();
+		(void)Exact->ToString();
+	}
+
+	return 0;
+}
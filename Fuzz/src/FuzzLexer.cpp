@@ -0,0 +1,43 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+
+// Tokens have to point into the input at their own position, a failed lex has to leave no tokens and an error
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, const size_t Size)
+{
+	if (Size > Fuzz::MAX_INPUT_LENGTH)
+	{
+		return 0;
+	}
+
+	const std::string_view Input(reinterpret_cast<const char*>(Data), Size);
+
+	ErrorManager Errors;
+	const std::pmr::vector<Token> Tokens = Lexer::GetTokens(Input, Errors);
+
+	WL_FUZZ_CHECK(Tokens.empty() == Errors.HasErrors());
+	WL_FUZZ_CHECK(Tokens.empty() || Tokens.back().Type == TYPE_EOF);
+
+	for (const Token& Current : Tokens)
+	{
+		WL_FUZZ_CHECK(Current.Start.Index >= 0 && Current.Start.Index <= static_cast<int32_t>(Size));
+
+		if (Current.Type == TYPE_INT || Current.Type == TYPE_FLOAT)
+		{
+			WL_FUZZ_CHECK(Current.Value.data() == Input.data() + Current.Start.Index);
+			WL_FUZZ_CHECK(Current.End.Index == Current.Start.Index + static_cast<int32_t>(Current.Value.size()));
+		}
+	}
+
+	for (const Error& Reported : Errors.GetErrors())
+	{
+		WL_FUZZ_CHECK(Reported.Start >= 0 && Reported.Start <= Reported.End && Reported.End <= static_cast<int32_t>(Size));
+		(void)Reported.StringWithArrows(Input);
+	}
+
+	return 0;
+}
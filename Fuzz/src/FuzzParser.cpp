@@ -0,0 +1,75 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+#include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Parser/Parser.h"
+
+// Children are created before their parent, every reference has to stay inside the tree and every span inside the
+// input. Spans at the end of the input cover the one character past it, where the caret of a missing operand goes.
+static void CheckTree(const SyntaxTree& Tree, const uint32_t Root, const size_t Size)
+{
+	WL_FUZZ_CHECK(Root < Tree.Nodes.size());
+
+	for (uint32_t Index = 0; Index < Tree.Nodes.size(); ++Index)
+	{
+		const SyntaxNode& Node = Tree.GetNode(Index);
+
+		WL_FUZZ_CHECK(Node.Start >= 0 && Node.Start <= Node.End && Node.End <= static_cast<int32_t>(Size) + 1);
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_NUMBER:
+			WL_FUZZ_CHECK(Node.Left < Tree.Literals.size());
+			break;
+
+		case NODE_TYPE_BINARY_OP:
+			WL_FUZZ_CHECK(Node.Left < Index && Node.Right < Index);
+			break;
+
+		case NODE_TYPE_UNARY_OP:
+			WL_FUZZ_CHECK(Node.Left < Index);
+			break;
+
+		case NODE_TYPE_ERROR:
+			break;
+
+		default:
+			WL_FUZZ_CHECK(false);
+		}
+	}
+}
+
+// Unlimited, then with limits small enough that the budget errors are reached
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, const size_t Size)
+{
+	if (Size > Fuzz::MAX_INPUT_LENGTH)
+	{
+		return 0;
+	}
+
+	const std::string_view Input(reinterpret_cast<const char*>(Data), Size);
+
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	CheckTree(Tree, Parser::GetExpressionResult(Input, Tree, Errors), Size);
+
+	EvaluationLimits Limits;
+	Limits.MaxNodeCount = 64;
+	Limits.MaxDepth = 16;
+
+	EvaluationBudget Budget(Limits);
+	ErrorManager LimitedErrors;
+	SyntaxTree LimitedTree;
+	CheckTree(LimitedTree, Parser::GetExpressionResult(Input, LimitedTree, LimitedErrors, &Budget), Size);
+
+	for (const Error& Reported : Errors.GetErrors())
+	{
+		(void)Reported.StringWithArrows(Input);
+		(void)Reported.GetDetails();
+	}
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Fuzz.h"
+
+#include <fstream>
+#include <iterator>
+
+/*
+ * Stand-in for the libFuzzer driver when building with GCC. Runs every file given on the command line through
+ * LLVMFuzzerTestOneInput, or standard input when there are none, so saved crashes can be replayed under the
+ * sanitizers and AFL++ can drive the target with "afl-fuzz -i <seeds> -o <findings> -- FuzzParser @@".
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	if (ArgumentCount < 2)
+	{
+		const std::string Input(std::istreambuf_iterator<char>(std::cin), {});
+		return LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(Input.data()), Input.size());
+	}
+
+	for (int32_t Index = 1; Index < ArgumentCount; ++Index)
+	{
+		std::ifstream File(Arguments[Index], std::ios::binary);
+
+		if (!File)
+		{
+			printf("Could not open %s\n", Arguments[Index]);
+			return 1;
+		}
+
+		const std::string Input(std::istreambuf_iterator<char>(File), {});
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(Input.data()), Input.size());
+	}
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+project "KernelGenerator"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	-- Core sources are shared with the LiveCalculator project, the UI is left out
+	files
+	{
+		"src/**.h",
+		"src/**.cpp",
+		"../LiveCalculator/src/Pch.h",
+		"../LiveCalculator/src/Pch.cpp",
+		"../LiveCalculator/src/Cache/**.h",
+		"../LiveCalculator/src/Cache/**.cpp",
+		"../LiveCalculator/src/ErrorManager.h",
+		"../LiveCalculator/src/ErrorManager.cpp",
+		"../LiveCalculator/src/EvaluationBudget.h",
+		"../LiveCalculator/src/EvaluationBudget.cpp",
+		"../LiveCalculator/src/Position.h",
+		"../LiveCalculator/src/Printable.h",
+		"../LiveCalculator/src/Trace.h",
+		"../LiveCalculator/src/Trace.cpp",
+		"../LiveCalculator/src/Lexer/**.h",
+		"../LiveCalculator/src/Lexer/**.cpp",
+		"../LiveCalculator/src/Parser/**.h",
+		"../LiveCalculator/src/Parser/**.cpp",
+		"../LiveCalculator/src/Interpreter/**.h",
+		"../LiveCalculator/src/Interpreter/**.cpp",
+		"../LiveCalculator/src/CodeGen/**.h",
+		"../LiveCalculator/src/CodeGen/**.cpp",
+		"Formulas.txt"
+	}
+
+	includedirs
+	{
+		"./src",
+		"../LiveCalculator/src",
+		"../vendor/imgui",
+	}
+
+	pchheader "Pch.h"
+	pchsource "../LiveCalculator/src/Pch.cpp"
+
+	targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+	-- Regenerate the kernels and the expression cache from the formula list after every build
+	postbuildcommands
+	{
+		"{MKDIR} \"%{prj.location}/Generated\"",
+		"\"%{cfg.buildtarget.abspath}\" \"%{prj.location}/Formulas.txt\" \"%{prj.location}/Generated/GeneratedKernels.h\" \"%{prj.location}/Generated/Formulas.cache\""
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+		defines { "WL_PLATFORM_WINDOWS" }
+
+	filter "configurations:Debug"
+		defines { "WL_DEBUG" }
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "WL_RELEASE" }
+		runtime "Release"
+		optimize "On"
+		symbols "On"
+
+	filter "configurations:Dist"
+		defines { "WL_DIST" }
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
\ No newline at end of file
@@ -0,0 +1,114 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "ErrorManager.h"
+#include "Cache/ExpressionCache.h"
+#include "CodeGen/KernelEmitter.h"
+#include "Interpreter/Interpreter.h"
+#include "Lexer/Lexer.h"
+#include "Parser/Parser.h"
+
+#include <fstream>
+
+/*
+ * Reads a formula list and writes a header of constexpr kernels.
+ * Usage: KernelGenerator <formula list> <output header> [<expression cache>]
+ *
+ * Every non-empty line that does not start with '#' has the form "Name: formula", Name must be a C++ identifier.
+ * The formulas are also written to the expression cache when one is given, see EvalServer --cache.
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	if (ArgumentCount != 3 && ArgumentCount != 4)
+	{
+		printf("Usage: KernelGenerator <formula list> <output header> [<expression cache>]\n");
+		return 1;
+	}
+
+	std::ifstream FormulaFile(Arguments[1]);
+
+	if (!FormulaFile)
+	{
+		printf("Failed to open %s\n", Arguments[1]);
+		return 1;
+	}
+
+	KernelEmitter Emitter;
+	ExpressionCacheWriter CacheWriter;
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	std::string Line;
+
+	while (std::getline(FormulaFile, Line))
+	{
+		if (Line.empty() || Line[0] == '#')
+		{
+			continue;
+		}
+
+		const size_t Separator = Line.find(':');
+
+		if (Separator == std::string::npos)
+		{
+			printf("Expected 'Name: formula', got '%s'\n", Line.c_str());
+			return 1;
+		}
+
+		const std::string Name = Line.substr(0, Separator);
+		std::string Formula = Line.substr(std::min(Line.find_first_not_of(" \t", Separator + 1), Line.size()));
+
+		// The name is emitted as a function name and inside a string literal
+		if (!Emitter.IsValidName(Name))
+		{
+			printf("Kernel name '%s' is not a C++ identifier, is reserved or is used twice\n", Name.c_str());
+			return 1;
+		}
+
+		Errors.Clear();
+		Tree.Clear();
+
+		const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+
+		// Formulas are constant, so evaluating once here catches runtime errors before they reach the kernel
+		if (!Errors.HasErrors())
+		{
+			(void)Interpreter::Visit(Tree, Root, Errors);
+		}
+
+		if (Errors.HasErrors())
+		{
+			for (const Error& CurrentError : Errors.GetErrors())
+			{
+				printf("%s: %s -> %s\n%s\n", Name.c_str(), CurrentError.GetName(), CurrentError.GetDetails().c_str(), CurrentError.StringWithArrows(Formula).c_str());
+			}
+
+			return 1;
+		}
+
+		Emitter.AddKernel(Tree, Root, Name, Formula);
+
+		if (!CacheWriter.Add(Formula, Errors))
+		{
+			printf("%s: failed to add the formula to the expression cache\n", Name.c_str());
+			return 1;
+		}
+	}
+
+	std::ofstream HeaderFile(Arguments[2]);
+
+	if (!HeaderFile)
+	{
+		printf("Failed to write %s\n", Arguments[2]);
+		return 1;
+	}
+
+	HeaderFile << Emitter.GetHeader();
+
+	if (ArgumentCount == 4 && !CacheWriter.Write(Arguments[3]))
+	{
+		printf("Failed to write %s\n", Arguments[3]);
+		return 1;
+	}
+
+	return 0;
+}
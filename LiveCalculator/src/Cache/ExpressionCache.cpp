@@ -0,0 +1,430 @@
+﻿#include "Pch.h"
+
+#include "ExpressionCache.h"
+#include "ErrorManager.h"
+#include "Parser/Parser.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace ExpressionCacheFormat;
+
+namespace ExpressionCacheFormat
+{
+	[[nodiscard]] uint64_t GetHash(const std::string_view Bytes)
+	{
+		uint64_t Hash = 14695981039346656037ull;
+
+		for (const char Byte : Bytes)
+		{
+			Hash ^= static_cast<uint8_t>(Byte);
+			Hash *= 1099511628211ull;
+		}
+
+		return Hash;
+	}
+}
+
+static uint64_t AlignUp(const uint64_t Offset, const uint64_t Alignment)
+{
+	return (Offset + Alignment - 1) / Alignment * Alignment;
+}
+
+// x87 long double keeps its 80 value bits in 12 or 16 bytes, the rest is padding like the gaps between fields
+static constexpr size_t FLOAT_VALUE_SIZE = std::numeric_limits<Number::FloatType>::digits == 64 ? 10 : sizeof(Number::FloatType);
+
+// Nodes and literals are copied field by field into the zeroed buffer. Their padding bytes are never initialized,
+// copying whole structs would write stray memory into the file and make every cache of the same formulas differ.
+static void WriteNode(char* Destination, const SyntaxNode& Node)
+{
+	std::memcpy(Destination + offsetof(SyntaxNode, Type), &Node.Type, sizeof(Node.Type));
+	std::memcpy(Destination + offsetof(SyntaxNode, Operator), &Node.Operator, sizeof(Node.Operator));
+	std::memcpy(Destination + offsetof(SyntaxNode, Left), &Node.Left, sizeof(Node.Left));
+	std::memcpy(Destination + offsetof(SyntaxNode, Right), &Node.Right, sizeof(Node.Right));
+	std::memcpy(Destination + offsetof(SyntaxNode, Start), &Node.Start, sizeof(Node.Start));
+	std::memcpy(Destination + offsetof(SyntaxNode, End), &Node.End, sizeof(Node.End));
+}
+
+static void WriteLiteral(char* Destination, const Number& Literal)
+{
+	std::memcpy(Destination + offsetof(Number, IsInt), &Literal.IsInt, sizeof(Literal.IsInt));
+	std::memcpy(Destination + offsetof(Number, IntValue), &Literal.IntValue, sizeof(Literal.IntValue));
+	std::memcpy(Destination + offsetof(Number, FloatValue), &Literal.FloatValue, FLOAT_VALUE_SIZE);
+}
+
+ExpressionCache::~ExpressionCache()
+{
+	Close();
+}
+
+bool ExpressionCache::Open(const std::string& Path)
+{
+	Close();
+
+#ifdef _WIN32
+	FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (FileHandle == INVALID_HANDLE_VALUE)
+	{
+		FileHandle = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+
+	if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	Data = MappingHandle != nullptr ? static_cast<const char*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	Size = static_cast<size_t>(FileSize.QuadPart);
+#else
+	const int File = open(Path.c_str(), O_RDONLY);
+
+	if (File == -1)
+	{
+		return false;
+	}
+
+	struct stat FileStatus;
+
+	if (fstat(File, &FileStatus) == 0 && FileStatus.st_size > 0)
+	{
+		void* Memory = mmap(nullptr, static_cast<size_t>(FileStatus.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+
+		if (Memory != MAP_FAILED)
+		{
+			Data = static_cast<const char*>(Memory);
+			Size = static_cast<size_t>(FileStatus.st_size);
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close(File);
+#endif
+
+	if (Data == nullptr || !Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void ExpressionCache::Close()
+{
+#ifdef _WIN32
+	if (Data != nullptr)
+	{
+		UnmapViewOfFile(Data);
+	}
+
+	if (MappingHandle != nullptr)
+	{
+		CloseHandle(MappingHandle);
+	}
+
+	if (FileHandle != nullptr)
+	{
+		CloseHandle(FileHandle);
+	}
+
+	MappingHandle = nullptr;
+	FileHandle = nullptr;
+#else
+	if (Data != nullptr)
+	{
+		munmap(const_cast<char*>(Data), Size);
+	}
+#endif
+
+	Data = nullptr;
+	Size = 0;
+}
+
+[[nodiscard]] bool ExpressionCache::Find(const std::string_view Source, uint32_t& OutRoot) const
+{
+	if (Data == nullptr)
+	{
+		return false;
+	}
+
+	const Header& FileHeader = GetHeader();
+	const Entry* Begin = GetEntries();
+	const Entry* End = Begin + FileHeader.EntryCount;
+	const uint64_t Hash = GetHash(Source);
+
+	const Entry* Current = std::lower_bound(Begin, End, Hash, [](const Entry& Candidate, const uint64_t Value)
+	{
+		return Candidate.SourceHash < Value;
+	});
+
+	for (; Current != End && Current->SourceHash == Hash; ++Current)
+	{
+		if (std::string_view(Data + FileHeader.SourceOffset + Current->SourceOffset, Current->SourceLength) == Source)
+		{
+			OutRoot = Current->Root;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+[[nodiscard]] SyntaxTreeView ExpressionCache::GetTree() const
+{
+	if (Data == nullptr)
+	{
+		return { {}, {} };
+	}
+
+	const Header& FileHeader = GetHeader();
+
+	return {
+		{ reinterpret_cast<const SyntaxNode*>(Data + FileHeader.NodeOffset), FileHeader.NodeCount },
+		{ reinterpret_cast<const Number*>(Data + FileHeader.LiteralOffset), FileHeader.LiteralCount }
+	};
+}
+
+[[nodiscard]] uint32_t ExpressionCache::GetEntryCount() const
+{
+	return Data != nullptr ? GetHeader().EntryCount : 0;
+}
+
+[[nodiscard]] std::string_view ExpressionCache::GetSource(const uint32_t EntryIndex) const
+{
+	const Entry& Current = GetEntries()[EntryIndex];
+	return std::string_view(Data + GetHeader().SourceOffset + Current.SourceOffset, Current.SourceLength);
+}
+
+[[nodiscard]] const Header& ExpressionCache::GetHeader() const
+{
+	return *reinterpret_cast<const Header*>(Data);
+}
+
+[[nodiscard]] const Entry* ExpressionCache::GetEntries() const
+{
+	return reinterpret_cast<const Entry*>(Data + sizeof(Header));
+}
+
+// Everything the interpreter relies on is checked here, a file that passes can be evaluated without further checks
+[[nodiscard]] bool ExpressionCache::Validate() const
+{
+	if (Size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header& FileHeader = GetHeader();
+
+	// Other version or a build with a different node or number layout or another number policy
+	if (FileHeader.Magic != MAGIC || FileHeader.Version != VERSION || FileHeader.NodeSize != sizeof(SyntaxNode)
+	    || FileHeader.NumberSize != sizeof(Number) || FileHeader.PolicyId != NumberPolicy::ID
+	    || FileHeader.FloatSize != sizeof(Number::FloatType) || FileHeader.FileSize != Size)
+	{
+		return false;
+	}
+
+	// Regions follow each other in order and are aligned for their element type
+	const uint64_t EntryEnd = sizeof(Header) + static_cast<uint64_t>(FileHeader.EntryCount) * sizeof(Entry);
+	const uint64_t NodeEnd = FileHeader.NodeOffset + static_cast<uint64_t>(FileHeader.NodeCount) * sizeof(SyntaxNode);
+	const uint64_t LiteralEnd = FileHeader.LiteralOffset + static_cast<uint64_t>(FileHeader.LiteralCount) * sizeof(Number);
+	const uint64_t SourceEnd = FileHeader.SourceOffset + static_cast<uint64_t>(FileHeader.SourceSize);
+
+	if (EntryEnd > FileHeader.NodeOffset || NodeEnd > FileHeader.LiteralOffset || LiteralEnd > FileHeader.SourceOffset || SourceEnd > Size
+	    || FileHeader.NodeOffset % alignof(SyntaxNode) != 0 || FileHeader.LiteralOffset % alignof(Number) != 0)
+	{
+		return false;
+	}
+
+	if (GetHash(std::string_view(Data + sizeof(Header), Size - sizeof(Header))) != FileHeader.Checksum)
+	{
+		return false;
+	}
+
+	const Entry* Entries = GetEntries();
+
+	for (uint32_t Index = 0; Index < FileHeader.EntryCount; ++Index)
+	{
+		const Entry& Current = Entries[Index];
+
+		if (Current.Root >= FileHeader.NodeCount || static_cast<uint64_t>(Current.SourceOffset) + Current.SourceLength > FileHeader.SourceSize)
+		{
+			return false;
+		}
+
+		if (Index > 0 && Entries[Index - 1].SourceHash > Current.SourceHash)
+		{
+			return false;
+		}
+	}
+
+	// Children before parents and literal indices in range, so evaluation never leaves the file
+	const SyntaxTreeView Tree = GetTree();
+
+	for (uint32_t Index = 0; Index < FileHeader.NodeCount; ++Index)
+	{
+		const SyntaxNode& Node = Tree.GetNode(Index);
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_NUMBER:
+			if (Node.Left >= FileHeader.LiteralCount || (Node.Operator != TYPE_INT && Node.Operator != TYPE_FLOAT))
+			{
+				return false;
+			}
+
+			break;
+
+		case NODE_TYPE_UNARY_OP:
+			if (Node.Left >= Index || (Node.Operator != TYPE_PLUS && Node.Operator != TYPE_MINUS))
+			{
+				return false;
+			}
+
+			break;
+
+		case NODE_TYPE_BINARY_OP:
+			if (Node.Left >= Index || Node.Right >= Index || Node.Operator < TYPE_PLUS || Node.Operator > TYPE_DIV)
+			{
+				return false;
+			}
+
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	// A bool holding anything but 0 or 1 is undefined behaviour, check the raw byte
+	for (uint32_t Index = 0; Index < FileHeader.LiteralCount; ++Index)
+	{
+		const uint8_t IsInt = static_cast<uint8_t>(Data[FileHeader.LiteralOffset + Index * sizeof(Number) + offsetof(Number, IsInt)]);
+
+		if (IsInt > 1)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Unique per call, writers of the same cache in other threads or processes never write into each other's file
+static std::string GetTemporaryPath(const std::string& Path)
+{
+	static std::atomic<uint64_t> WriteCount = 0;
+
+	std::random_device Device;
+	const uint64_t Random = static_cast<uint64_t>(Device()) << 32 | Device();
+
+	return std::format("{}.{:016x}.{}.tmp", Path, Random, WriteCount++);
+}
+
+bool ExpressionCacheWriter::Add(const std::string_view Source, ErrorManager& Errors)
+{
+	const size_t NodeCount = Tree.Nodes.size();
+	const size_t LiteralCount = Tree.Literals.size();
+	const size_t ErrorCount = Errors.GetErrors().size();
+
+	const uint32_t Root = Parser::GetExpressionResult(Source, Tree, Errors);
+
+	if (Errors.GetErrors().size() != ErrorCount)
+	{
+		Tree.Nodes.resize(NodeCount);
+		Tree.Literals.resize(LiteralCount);
+		return false;
+	}
+
+	Entries.push_back({ std::string(Source), Root });
+	return true;
+}
+
+bool ExpressionCacheWriter::Write(const std::string& Path) const
+{
+	std::vector<Entry> SortedEntries;
+	std::string Sources;
+
+	for (const PendingEntry& Current : Entries)
+	{
+		SortedEntries.push_back({ GetHash(Current.Source), static_cast<uint32_t>(Sources.size()), static_cast<uint32_t>(Current.Source.size()), Current.Root, 0 });
+		Sources += Current.Source;
+	}
+
+	std::stable_sort(SortedEntries.begin(), SortedEntries.end(), [](const Entry& Left, const Entry& Right)
+	{
+		return Left.SourceHash < Right.SourceHash;
+	});
+
+	Header FileHeader{};
+	FileHeader.Magic = MAGIC;
+	FileHeader.Version = VERSION;
+	FileHeader.NodeSize = sizeof(SyntaxNode);
+	FileHeader.NumberSize = sizeof(Number);
+	FileHeader.PolicyId = NumberPolicy::ID;
+	FileHeader.FloatSize = sizeof(Number::FloatType);
+	FileHeader.EntryCount = static_cast<uint32_t>(SortedEntries.size());
+	FileHeader.NodeOffset = static_cast<uint32_t>(AlignUp(sizeof(Header) + SortedEntries.size() * sizeof(Entry), alignof(SyntaxNode)));
+	FileHeader.NodeCount = static_cast<uint32_t>(Tree.Nodes.size());
+	FileHeader.LiteralOffset = static_cast<uint32_t>(AlignUp(FileHeader.NodeOffset + Tree.Nodes.size() * sizeof(SyntaxNode), alignof(Number)));
+	FileHeader.LiteralCount = static_cast<uint32_t>(Tree.Literals.size());
+	FileHeader.SourceOffset = static_cast<uint32_t>(FileHeader.LiteralOffset + Tree.Literals.size() * sizeof(Number));
+	FileHeader.SourceSize = static_cast<uint32_t>(Sources.size());
+	FileHeader.FileSize = FileHeader.SourceOffset + Sources.size();
+
+	std::vector<char> Buffer(FileHeader.FileSize);
+
+	std::memcpy(Buffer.data() + sizeof(Header), SortedEntries.data(), SortedEntries.size() * sizeof(Entry));
+
+	for (size_t Index = 0; Index < Tree.Nodes.size(); ++Index)
+	{
+		WriteNode(Buffer.data() + FileHeader.NodeOffset + Index * sizeof(SyntaxNode), Tree.Nodes[Index]);
+	}
+
+	for (size_t Index = 0; Index < Tree.Literals.size(); ++Index)
+	{
+		WriteLiteral(Buffer.data() + FileHeader.LiteralOffset + Index * sizeof(Number), Tree.Literals[Index]);
+	}
+
+	std::memcpy(Buffer.data() + FileHeader.SourceOffset, Sources.data(), Sources.size());
+
+	FileHeader.Checksum = GetHash(std::string_view(Buffer.data() + sizeof(Header), Buffer.size() - sizeof(Header)));
+	std::memcpy(Buffer.data(), &FileHeader, sizeof(Header));
+
+	const std::string TemporaryPath = GetTemporaryPath(Path);
+	bool IsWritten;
+
+	{
+		std::ofstream File(TemporaryPath, std::ios::binary | std::ios::trunc);
+		File.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+		IsWritten = File.good();
+	}
+
+	std::error_code FileError;
+
+	if (IsWritten)
+	{
+		std::filesystem::rename(TemporaryPath, Path, FileError);
+	}
+
+	if (!IsWritten || FileError)
+	{
+		std::filesystem::remove(TemporaryPath, FileError);
+		return false;
+	}
+
+	return true;
+}
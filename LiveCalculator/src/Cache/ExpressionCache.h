@@ -0,0 +1,124 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+
+class ErrorManager;
+
+/*
+ * Parsed expressions stored in one file that is memory mapped and evaluated in place, warm starts skip the
+ * Lexer and Parser entirely:
+ *
+ *		ExpressionCache Cache;
+ *		uint32_t Root;
+ *
+ *		if (Cache.Open(Path) && Cache.Find(Formula, Root))
+ *		{
+ *			Interpreter::Visit(Cache.GetTree(), Root, Errors);
+ *		}
+ *
+ * Layout: header, entries sorted by source hash, the shared node pool, the literal pool and the source texts.
+ * The header records the format version, the node and literal sizes and the number policy, a checksum covers
+ * everything after it. Number is 24 bytes with both double and float, only the policy tells those files apart. Open() rejects files from another version or build and files that fail the checksum or bounds checks,
+ * the caller then rebuilds the file with ExpressionCacheWriter.
+ */
+namespace ExpressionCacheFormat
+{
+	inline constexpr uint32_t MAGIC = 0x4345434C; // "LCEC"
+	inline constexpr uint32_t VERSION = 2;
+
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t NodeSize;
+		uint32_t NumberSize;
+		uint64_t FileSize;
+		uint64_t Checksum;
+		uint32_t EntryCount;
+		uint32_t NodeOffset;
+		uint32_t NodeCount;
+		uint32_t LiteralOffset;
+		uint32_t LiteralCount;
+		uint32_t SourceOffset;
+		uint32_t SourceSize;
+		uint8_t PolicyId;  // NumberPolicy::ID
+		uint8_t FloatSize; // sizeof(Number::FloatType)
+		uint16_t Reserved;
+	};
+
+	struct Entry
+	{
+		uint64_t SourceHash;
+		uint32_t SourceOffset; // Relative to Header::SourceOffset
+		uint32_t SourceLength;
+		uint32_t Root;
+		uint32_t Reserved;
+	};
+
+	static_assert(sizeof(Header) == 64);
+	static_assert(sizeof(Entry) == 24);
+
+	// FNV-1a, used for both the entry keys and the file checksum
+	[[nodiscard]] uint64_t GetHash(std::string_view Bytes);
+}
+
+// Read side, maps a file written by ExpressionCacheWriter
+class ExpressionCache
+{
+public:
+	ExpressionCache() = default;
+	~ExpressionCache();
+
+	ExpressionCache(const ExpressionCache&) = delete;
+	ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+	// Returns false when the file is missing, stale or corrupt
+	bool Open(const std::string& Path);
+	void Close();
+
+	// Looks the source text up by hash, the stored text is compared as well so collisions are never returned
+	[[nodiscard]] bool Find(std::string_view Source, uint32_t& OutRoot) const;
+
+	// Nodes and literals of every cached expression, valid until Close()
+	[[nodiscard]] SyntaxTreeView GetTree() const;
+
+	// Source texts in hash order, so a rebuilt file can keep the expressions of this one
+	[[nodiscard]] uint32_t GetEntryCount() const;
+	[[nodiscard]] std::string_view GetSource(uint32_t EntryIndex) const;
+
+	// Protected fields and functions
+protected:
+	[[nodiscard]] bool Validate() const;
+	[[nodiscard]] const ExpressionCacheFormat::Header& GetHeader() const;
+	[[nodiscard]] const ExpressionCacheFormat::Entry* GetEntries() const;
+
+	const char* Data = nullptr;
+	size_t Size = 0;
+
+#ifdef _WIN32
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+#endif
+};
+
+// Write side, collects parsed expressions and writes them in the cache format
+class ExpressionCacheWriter
+{
+public:
+	// Parses and stores Source, returns false and leaves the cache unchanged when it has syntax errors
+	bool Add(std::string_view Source, ErrorManager& Errors);
+
+	// Writes to a uniquely named temporary file first and renames it, readers never see a half written cache
+	bool Write(const std::string& Path) const;
+
+	// Protected fields and functions
+protected:
+	struct PendingEntry
+	{
+		std::string Source;
+		uint32_t Root;
+	};
+
+	SyntaxTree Tree;
+	std::vector<PendingEntry> Entries;
+};
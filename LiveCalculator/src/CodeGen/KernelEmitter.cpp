@@ -0,0 +1,167 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "KernelEmitter.h"
+
+static const char* GetOperatorFunction(const ETokenType Type)
+{
+	switch (Type)
+	{
+	case TYPE_PLUS:
+		return "AddedTo";
+
+	case TYPE_MINUS:
+		return "SubtractedBy";
+
+	case TYPE_MUL:
+		return "MultipliedBy";
+
+	case TYPE_DIV:
+		return "DividedBy";
+
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+[[nodiscard]] bool KernelEmitter::IsValidName(const std::string_view Name) const
+{
+	// Every C++20 keyword and alternative token, plus the names the generated header declares itself
+	static constexpr std::string_view RESERVED_NAMES[] =
+	{
+		"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+		"char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr", "constinit",
+		"const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do", "double",
+		"dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if",
+		"inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+		"or_eq", "private", "protected", "public", "register", "reinterpret_cast", "requires", "return", "short", "signed",
+		"sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+		"true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+		"wchar_t", "while", "xor", "xor_eq",
+		"Number", "KernelEntry", "GKernels"
+	};
+
+	// [A-Za-z_][A-Za-z0-9_]*, spelled out because <cctype> depends on the locale
+	if (Name.empty() || (Name[0] >= '0' && Name[0] <= '9'))
+	{
+		return false;
+	}
+
+	for (const char Character : Name)
+	{
+		const bool IsLetter = (Character >= 'a' && Character <= 'z') || (Character >= 'A' && Character <= 'Z');
+		const bool IsDigit = Character >= '0' && Character <= '9';
+
+		if (!IsLetter && !IsDigit && Character != '_')
+		{
+			return false;
+		}
+	}
+
+	return std::find(std::begin(RESERVED_NAMES), std::end(RESERVED_NAMES), Name) == std::end(RESERVED_NAMES)
+		&& std::find(Names.begin(), Names.end(), Name) == Names.end();
+}
+
+void KernelEmitter::AddKernel(const SyntaxTree& Tree, const uint32_t Root, const std::string& Name, const std::string& Formula)
+{
+	ValueCount = 0;
+	Names.push_back(Name);
+
+	Kernels += std::format("\t// {}\n", Formula);
+	Kernels += std::format("\t[[nodiscard]] constexpr Number {}()\n", Name);
+	Kernels += "\t{\n";
+
+	const std::string Result = EmitNode(Tree, Root);
+
+	Kernels += std::format("\t\treturn {};\n", Result);
+	Kernels += "\t}\n\n";
+
+	TableEntries += std::format("\t\t{{ \"{}\", \"{}\", &{} }},\n", Name, Formula, Name);
+}
+
+[[nodiscard]] std::string KernelEmitter::GetHeader() const
+{
+	std::string Header;
+
+	Header += "// Generated by KernelGenerator, do not edit\n";
+	Header += "#pragma once\n\n";
+	Header += "#include <cstdint>\n";
+	Header += "#include <limits>\n\n";
+	Header += "#include \"Interpreter/Number.h\"\n\n";
+	Header += "namespace Kernels\n{\n";
+	Header += Kernels;
+	Header += "\tstruct KernelEntry\n\t{\n";
+	Header += "\t\tconst char* Name;\n";
+	Header += "\t\tconst char* Formula;\n";
+	Header += "\t\tNumber (*Function)();\n";
+	Header += "\t};\n\n";
+	Header += "\tinline constexpr KernelEntry GKernels[] =\n\t{\n";
+	Header += TableEntries;
+	Header += "\t};\n}\n";
+
+	return Header;
+}
+
+[[nodiscard]] std::string KernelEmitter::EmitNode(const SyntaxTree& Tree, const uint32_t NodeIndex)
+{
+	const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+	std::string Expression;
+
+	switch (Node.Type)
+	{
+	case NODE_TYPE_NUMBER:
+	{
+		const Number& Literal = Tree.GetLiteral(Node);
+
+		if (Literal.IsInt)
+		{
+			Expression = std::format("Number(INT64_C({}))", Literal.IntValue);
+		}
+		else if (Literal.FloatValue == std::numeric_limits<Number::FloatType>::infinity())
+		{
+			Expression = "Number(std::numeric_limits<Number::FloatType>::infinity())";
+		}
+		else
+		{
+			// Hex float literals carry the parsed value over bit for bit
+			char Buffer[64];
+			const std::to_chars_result Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Literal.FloatValue, std::chars_format::hex);
+			Expression = std::format("Number(0x{}{})", std::string_view(Buffer, Result.ptr), NumberPolicy::LITERAL_SUFFIX);
+		}
+
+		break;
+	}
+
+	case NODE_TYPE_BINARY_OP:
+	{
+		const std::string Left = EmitNode(Tree, Node.Left);
+		const std::string Right = EmitNode(Tree, Node.Right);
+
+		Expression = std::format("{}.{}({})", Left, GetOperatorFunction(Node.Operator), Right);
+		break;
+	}
+
+	case NODE_TYPE_UNARY_OP:
+	{
+		const std::string Child = EmitNode(Tree, Node.Left);
+
+		if (Node.Operator != TYPE_MINUS)
+		{
+			return Child;
+		}
+
+		Expression = std::format("{}.MultipliedBy(Number(INT64_C(-1)))", Child);
+		break;
+	}
+
+	case NODE_TYPE_ERROR:
+		break;
+	}
+
+	const std::string ValueName = std::format("Value{}", ValueCount++);
+	Kernels += std::format("\t\tconstexpr Number {} = {};\n", ValueName, Expression);
+
+	return ValueName;
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+
+// Turns parsed syntax trees into a C++ header of straight-line constexpr kernels. Every node becomes one
+// Number temporary in evaluation order, so the compiler can inline and fold the whole formula.
+class KernelEmitter
+{
+public:
+	// Name becomes a function name and a string literal in the header, it must be a C++ identifier that is not a
+	// keyword, not a name the header already uses and not the name of an earlier kernel
+	[[nodiscard]] bool IsValidName(std::string_view Name) const;
+
+	// Root must come from a parse and evaluation without errors, Name must pass IsValidName()
+	void AddKernel(const SyntaxTree& Tree, uint32_t Root, const std::string& Name, const std::string& Formula);
+
+	// Header with every added kernel plus a GKernels table for comparing against the interpreter
+	[[nodiscard]] std::string GetHeader() const;
+
+	// Protected fields and functions
+protected:
+	[[nodiscard]] std::string EmitNode(const SyntaxTree& Tree, uint32_t NodeIndex);
+
+	std::vector<std::string> Names;
+	std::string Kernels;
+	std::string TableEntries;
+	int32_t ValueCount = 0;
+};
@@ -0,0 +1,33 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "DiagnosticRenderer.h"
+#include "ErrorManager.h"
+
+[[nodiscard]] const std::pmr::string& DiagnosticRenderer::Render(const std::string_view Input, const uint64_t Revision, const ErrorManager& Errors)
+{
+	if (Revision == RenderedRevision)
+	{
+		return Text;
+	}
+
+	RenderedRevision = Revision;
+	Text.clear();
+
+	for (const Error& CurrentError : Errors.GetErrors())
+	{
+		if (!Text.empty())
+		{
+			Text += '\n';
+		}
+
+		CurrentError.AppendWithArrows(Text, Input);
+
+		Text += "\nError: ";
+		Text += CurrentError.GetName();
+		Text += " -> ";
+		Text += CurrentError.GetDetails(Text.get_allocator().resource());
+	}
+
+	return Text;
+}
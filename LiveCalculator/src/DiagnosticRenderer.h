@@ -0,0 +1,25 @@
+﻿#pragma once
+
+class ErrorManager;
+
+/*
+ * Renders the errors of one evaluation for display and keeps the text until the input changes. The caller bumps
+ * Revision whenever it re-runs the pipeline, calls with an unchanged revision return the cached text without
+ * touching the errors, so redrawing the same diagnostics every frame costs nothing.
+ */
+class DiagnosticRenderer
+{
+public:
+	explicit DiagnosticRenderer(std::pmr::memory_resource* Resource = std::pmr::get_default_resource())
+		: Text(Resource)
+	{
+	}
+
+	// Every error as its source lines with arrows under the span, followed by "Error: Name -> details"
+	[[nodiscard]] const std::pmr::string& Render(std::string_view Input, uint64_t Revision, const ErrorManager& Errors);
+
+	// Protected fields and functions
+protected:
+	std::pmr::string Text;
+	uint64_t RenderedRevision = UINT64_MAX;
+};
@@ -3,87 +3,108 @@
 
 #include "ErrorManager.h"
 
-std::unique_ptr<Error> ErrorManager::LastError = std::make_unique<Error>();
-
-[[nodiscard]] std::string Error::StringWithArrows(const std::string& Text) const
+[[nodiscard]] std::pmr::string Error::GetDetails(std::pmr::memory_resource* Resource) const
 {
-	std::string ReturnValue;
-
-	uint64_t IndexStart = std::max(Text.rfind('\n', Start.Index), 0ui64);
-	uint64_t IndexEnd = Text.find('\n', IndexStart + 1);
+	const char* Details = "";
 
-	if (IndexStart == std::string::npos)
+	switch (Code)
 	{
-		IndexStart = 0;
-	}
+	case ERROR_ILLEGAL_CHARACTER:
+		return std::pmr::string({ '\'', Character, '\'' }, Resource);
 
-	if (IndexEnd == std::string::npos)
-	{
-		IndexEnd = Text.length();
-	}
+	case ERROR_EXPECTED_OPERATOR:
+		Details = "Expected operator ('+', '-', '*', '/')";
+		break;
 
-	const int LineCount = End.LineNumber - Start.LineNumber + 1;
+	case ERROR_EXPECTED_RBRACKET:
+		Details = "Expected ')'";
+		break;
 
-	for (int LineIndex = 0; LineIndex < LineCount; ++LineIndex)
-	{
-		std::string Line = Text.substr(IndexStart, IndexEnd - IndexStart);
+	case ERROR_EXPECTED_NUMBER:
+		Details = "Expected integer or floating-point number";
+		break;
 
-		int ColumnStart;
-		int ColumnEnd;
+	case ERROR_DIVISION_BY_ZERO:
+		Details = "Integer Division by 0";
+		break;
 
-		if (LineIndex == 0)
-		{
-			ColumnStart = Start.ColumnNumber;
-		}
-		else
-		{
-			ColumnStart = 0;
-		}
+	case ERROR_INPUT_TOO_LARGE:
+		Details = "Input is longer than allowed";
+		break;
 
-		if (LineIndex == LineCount - 1)
-		{
-			ColumnEnd = End.ColumnNumber;
-		}
-		else
-		{
-			ColumnEnd = static_cast<int>(Line.length()) - 1;
-		}
+	case ERROR_TOO_MANY_NODES:
+		Details = "Expression has more nodes than allowed";
+		break;
 
-		ReturnValue += Line + '\n';
-
-		// Add out whitespace
-		for (int ColumnIndex = 0; ColumnIndex < ColumnStart; ++ColumnIndex)
-		{
-			ReturnValue += ' ';
-		}
+	case ERROR_TOO_DEEP:
+		Details = "Expression is nested deeper than allowed";
+		break;
 
-		// Add our arrows
-		for (int ColumnIndex = 0; ColumnIndex < ColumnEnd - ColumnStart; ++ColumnIndex)
-		{
-			ReturnValue += '^';
-		}
+	case ERROR_TOO_MANY_OPERATIONS:
+		Details = "Evaluation needs more operations than allowed";
+		break;
 
-		// Recalculate indexes
-		IndexStart = IndexEnd;
-		IndexEnd = Text.find('\n', IndexStart + 1);
+	case ERROR_TIMED_OUT:
+		Details = "Evaluation took longer than allowed";
+		break;
 
-		if (IndexEnd == std::string::npos)
-		{
-			IndexEnd = Text.length();
-		}
+	case ERROR_CANCELLED:
+		Details = "Evaluation was cancelled";
+		break;
 	}
 
-	std::erase(ReturnValue, '\t');
-
-	return ReturnValue;
+	return std::pmr::string(Details, Resource);
 }
 
-[[nodiscard]] Error* ErrorManager::GetLastError()
+[[nodiscard]] std::pmr::string Error::StringWithArrows(const std::string_view Text, std::pmr::memory_resource* Resource) const
 {
-	return LastError.get();
+	std::pmr::string ReturnValue(Resource);
+	AppendWithArrows(ReturnValue, Text);
+
+	return ReturnValue;
 }
 
-bool ErrorManager::CheckLastError()
+void Error::AppendWithArrows(std::pmr::string& OutText, const std::string_view Text, const int32_t StartIndex, const int32_t EndIndex)
 {
-	return LastError->ErrorName.empty();
+	const size_t TextLength = Text.size();
+
+	// Spans at the end of the input (a missing operand) point one past the last character, mark at least one column
+	const size_t SpanStart = std::min(static_cast<size_t>(std::max(StartIndex, 0)), TextLength);
+	const size_t SpanEnd = std::max(static_cast<size_t>(std::max(EndIndex, 0)), SpanStart + 1);
+
+	const size_t FirstLineStart = SpanStart == 0 ? 0 : Text.rfind('\n', SpanStart - 1) + 1;
+	const size_t LastLineEnd = std::min(Text.find('\n', SpanEnd - 1), TextLength);
+
+	// Every line is written twice at most, plus one arrow past its end and two line breaks
+	OutText.reserve(OutText.size() + 2 * (LastLineEnd - FirstLineStart) + 3 * (SpanEnd - SpanStart + 1));
+
+	for (size_t LineStart = FirstLineStart; ; )
+	{
+		const size_t LineEnd = std::min(Text.find('\n', LineStart), TextLength);
+
+		if (LineStart != FirstLineStart)
+		{
+			OutText += '\n';
+		}
+
+		// Tabs become single spaces so the arrows line up with the column a tab takes in the span
+		const size_t LineOffset = OutText.size();
+		OutText.append(Text.substr(LineStart, LineEnd - LineStart));
+		std::replace(OutText.begin() + static_cast<ptrdiff_t>(LineOffset), OutText.end(), '\t', ' ');
+		OutText += '\n';
+
+		// The line break itself can be spanned, so arrows may reach one column past the end of the line
+		const size_t ArrowStart = std::max(SpanStart, LineStart) - LineStart;
+		const size_t ArrowEnd = std::min(SpanEnd, LineEnd + 1) - LineStart;
+
+		OutText.append(ArrowStart, ' ');
+		OutText.append(ArrowEnd - ArrowStart, '^');
+
+		if (LineEnd >= TextLength || LineEnd + 1 >= SpanEnd)
+		{
+			break;
+		}
+
+		LineStart = LineEnd + 1;
+	}
 }
@@ -1,68 +1,130 @@
 ﻿#pragma once
 
-#include "Printable.h"
-#include "Position.h"
+enum EErrorCode : uint8_t
+{
+	ERROR_ILLEGAL_CHARACTER,
+	ERROR_EXPECTED_OPERATOR,
+	ERROR_EXPECTED_RBRACKET,
+	ERROR_EXPECTED_NUMBER,
+	ERROR_DIVISION_BY_ZERO,
+
+	// Reported by EvaluationBudget
+	ERROR_INPUT_TOO_LARGE,
+	ERROR_TOO_MANY_NODES,
+	ERROR_TOO_DEEP,
+	ERROR_TOO_MANY_OPERATIONS,
+	ERROR_TIMED_OUT,
+	ERROR_CANCELLED
+};
+
+inline const char* GErrorNames[] =
+{
+	"Illegal Character",
+	"Invalid Syntax",
+	"Invalid Syntax",
+	"Invalid Syntax",
+	"Runtime Error",
+	"Limit Exceeded",
+	"Limit Exceeded",
+	"Limit Exceeded",
+	"Limit Exceeded",
+	"Limit Exceeded",
+	"Cancelled"
+};
 
+// Compact error record. Only a code and a span are stored, the readable message is built on demand.
 class Error
 {
 public:
-	Error() // Constructor for no error
-		: Error("", "", Position(0, 0, 0, ""), Position(0, 0, 0, ""))
+	explicit Error(const EErrorCode Code,
+	               const int32_t StartIndex,
+	               const int32_t EndIndex,
+	               const char Character = '\0')
+		: Code(Code),
+		  Character(Character),
+		  Start(StartIndex),
+		  End(EndIndex)
 	{
 	}
 
-	explicit Error(std::string ErrorName,
-	               std::string Details,
-	               Position PosStart,
-	               Position PosEnd)
-		: ErrorName(std::move(ErrorName)),
-		  Details(std::move(Details)),
-		  Start(std::move(PosStart)),
-		  End(std::move(PosEnd))
+	[[nodiscard]] const char* GetName() const
 	{
+		return GErrorNames[Code];
 	}
 
-	[[nodiscard]] std::string StringWithArrows(const std::string& Text) const;
+	[[nodiscard]] std::pmr::string GetDetails(std::pmr::memory_resource* Resource = std::pmr::get_default_resource()) const;
+	[[nodiscard]] std::pmr::string StringWithArrows(std::string_view Text, std::pmr::memory_resource* Resource = std::pmr::get_default_resource()) const;
 
-	[[nodiscard]] Error* GetError()
+	// Appends every source line the span touches, each followed by a line of '^' under the spanned characters
+	void AppendWithArrows(std::pmr::string& OutText, std::string_view Text) const
 	{
-		return this;
+		AppendWithArrows(OutText, Text, Start, End);
 	}
 
-	std::string ErrorName;
-	std::string Details;
+	// Same for any span, also used to point at the hot spots in an EvaluationProfile report
+	static void AppendWithArrows(std::pmr::string& OutText, std::string_view Text, int32_t StartIndex, int32_t EndIndex);
 
-	// Protected fields and functions
-protected:
-	Position Start;
-	Position End;
+	EErrorCode Code;
+
+	// Offending character for ERROR_ILLEGAL_CHARACTER
+	char Character;
+
+	// Span as character offsets
+	int32_t Start;
+	int32_t End;
 };
 
+// Per-evaluation diagnostics sink. The lexer, parser and interpreter report into the instance they are given,
+// so several errors can be collected in one pass and checking for errors is a single flag test.
 class ErrorManager
 {
 	// Access functions
 public:
-	// Return the stored error object if an error was stored, returns nullptr if no error.
-	[[nodiscard]] static Error* GetLastError();
+	ErrorManager() = default;
+
+	explicit ErrorManager(std::pmr::memory_resource* Resource)
+		: Errors(Resource)
+	{
+	}
+
+	// Returns true if any error has been reported since the last Clear().
+	[[nodiscard]] bool HasErrors() const
+	{
+		return HasErrorFlag;
+	}
+
+	// Returns the first reported error, or nullptr if no error.
+	[[nodiscard]] const Error* GetFirstError() const
+	{
+		return HasErrorFlag ? &Errors.front() : nullptr;
+	}
+
+	[[nodiscard]] const std::pmr::vector<Error>& GetErrors() const
+	{
+		return Errors;
+	}
 
-	// Returns true if no error is found from the last operation.
-	static bool CheckLastError();
+	// Store error info
+	const Error* ReportError(const EErrorCode Code, const int32_t StartIndex, const int32_t EndIndex, const char Character = '\0')
+	{
+		HasErrorFlag = true;
+		return &Errors.emplace_back(Code, StartIndex, EndIndex, Character);
+	}
 
-	// Set error info
-	static Error* SetLastError(Error InError)
+	void Reserve(const size_t ErrorCount)
 	{
-		*LastError = std::move(InError);
-		return LastError.get();
+		Errors.reserve(ErrorCount);
 	}
 
-	// Clear all error info
-	static void Clear()
+	// Clear all error info, keeps the storage for reuse
+	void Clear()
 	{
-		LastError->ErrorName.clear();
-		LastError->Details.clear();
+		Errors.clear();
+		HasErrorFlag = false;
 	}
 
 	// Protected fields and functions
 protected:
-	static std::unique_ptr<Error> LastError;
+	std::pmr::vector<Error> Errors;
+	bool HasErrorFlag = false;
 };
@@ -0,0 +1,87 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "EvaluationBudget.h"
+
+EvaluationBudget::EvaluationBudget(const EvaluationLimits& Limits, const CancelToken* Cancel)
+	: Limits(Limits),
+	  Cancel(Cancel),
+	  Deadline(std::chrono::steady_clock::time_point::max())
+{
+	const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+
+	if (Limits.MaxDuration < Deadline - Now)
+	{
+		Deadline = Now + Limits.MaxDuration;
+	}
+}
+
+[[nodiscard]] bool EvaluationBudget::CheckInputLength(const size_t Length, ErrorManager& Errors)
+{
+	if (Length > Limits.MaxInputLength)
+	{
+		return Exhaust(ERROR_INPUT_TOO_LARGE, Errors, static_cast<int32_t>(std::min<size_t>(Limits.MaxInputLength, INT32_MAX)), static_cast<int32_t>(std::min<size_t>(Length, INT32_MAX)));
+	}
+
+	return !Exhausted;
+}
+
+[[nodiscard]] bool EvaluationBudget::CheckDepth(const uint32_t Depth, ErrorManager& Errors, const int32_t Start, const int32_t End)
+{
+	if (Depth > Limits.MaxDepth)
+	{
+		return Exhaust(ERROR_TOO_DEEP, Errors, Start, End);
+	}
+
+	return !Exhausted;
+}
+
+[[nodiscard]] bool EvaluationBudget::AddNode(ErrorManager& Errors, const int32_t Start, const int32_t End)
+{
+	if (++NodeCount > Limits.MaxNodeCount)
+	{
+		return Exhaust(ERROR_TOO_MANY_NODES, Errors, Start, End);
+	}
+
+	return !Exhausted;
+}
+
+bool EvaluationBudget::Check(ErrorManager& Errors, const int32_t Start, const int32_t End)
+{
+	if (Exhausted)
+	{
+		return false;
+	}
+
+	if (OperationCount > Limits.MaxOperationCount)
+	{
+		return Exhaust(ERROR_TOO_MANY_OPERATIONS, Errors, Start, End);
+	}
+
+	if (Cancel != nullptr && Cancel->IsCancelled())
+	{
+		return Exhaust(ERROR_CANCELLED, Errors, Start, End);
+	}
+
+	if (Deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() > Deadline)
+	{
+		return Exhaust(ERROR_TIMED_OUT, Errors, Start, End);
+	}
+
+	// The next check is due after another interval or right past the operation limit, whichever comes first
+	NextCheck = std::min(OperationCount + CHECK_INTERVAL, Limits.MaxOperationCount == UINT64_MAX ? UINT64_MAX : Limits.MaxOperationCount + 1);
+	return true;
+}
+
+bool EvaluationBudget::Exhaust(const EErrorCode Code, ErrorManager& Errors, const int32_t Start, const int32_t End)
+{
+	if (!Exhausted)
+	{
+		Exhausted = true;
+		Errors.ReportError(Code, Start, End);
+	}
+
+	// Every later Spend() goes straight to Check(), which returns false
+	NextCheck = 0;
+	return false;
+}
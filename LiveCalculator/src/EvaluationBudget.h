@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include "ErrorManager.h"
+
+#include <chrono>
+
+// Per-evaluation limits for formulas from untrusted sources, the defaults are unlimited
+struct EvaluationLimits
+{
+	size_t MaxInputLength = SIZE_MAX;
+	uint32_t MaxNodeCount = UINT32_MAX;
+
+	// Nesting of brackets and signs while parsing. Chains of binary operators are parsed in a loop and are
+	// only bounded by MaxNodeCount, the recursive interpreters still descend one level per operator.
+	uint32_t MaxDepth = UINT32_MAX;
+
+	// Tokens lexed plus nodes visited by an interpreter
+	uint64_t MaxOperationCount = UINT64_MAX;
+
+	std::chrono::steady_clock::duration MaxDuration = std::chrono::steady_clock::duration::max();
+};
+
+// Set from another thread to stop an evaluation at its next budget check
+class CancelToken
+{
+public:
+	void Cancel() { Cancelled.store(true, std::memory_order_relaxed); }
+	void Reset() { Cancelled.store(false, std::memory_order_relaxed); }
+	[[nodiscard]] bool IsCancelled() const { return Cancelled.load(std::memory_order_relaxed); }
+
+	// Protected fields and functions
+protected:
+	std::atomic<bool> Cancelled = false;
+};
+
+/*
+ * Tracks one evaluation against its limits. The Lexer, Parser, Interpreter and RationalInterpreter take an
+ * optional budget and charge their work to it, the first limit that is exceeded is reported through the
+ * ErrorManager (ERROR_INPUT_TOO_LARGE ... ERROR_CANCELLED) and every stage then stops as if the input ended.
+ *
+ * Spend() is a counter increment and a compare, the clock and the cancel token are only read every
+ * CHECK_INTERVAL operations.
+ */
+class EvaluationBudget
+{
+public:
+	static constexpr uint64_t CHECK_INTERVAL = 1024;
+
+	explicit EvaluationBudget(const EvaluationLimits& Limits, const CancelToken* Cancel = nullptr);
+
+	// The Start and End arguments are the span an error is reported at. Every function returns false once any
+	// limit has been exceeded, only the first one is reported.
+	[[nodiscard]] bool Spend(ErrorManager& Errors, const int32_t Start, const int32_t End, const uint64_t Count = 1)
+	{
+		OperationCount += Count;
+		return OperationCount < NextCheck || Check(Errors, Start, End);
+	}
+
+	[[nodiscard]] bool CheckInputLength(size_t Length, ErrorManager& Errors);
+	[[nodiscard]] bool CheckDepth(uint32_t Depth, ErrorManager& Errors, int32_t Start, int32_t End);
+	[[nodiscard]] bool AddNode(ErrorManager& Errors, int32_t Start, int32_t End);
+
+	[[nodiscard]] bool IsExhausted() const { return Exhausted; }
+	[[nodiscard]] uint64_t GetOperationCount() const { return OperationCount; }
+
+	// Protected fields and functions
+protected:
+	bool Check(ErrorManager& Errors, int32_t Start, int32_t End);
+	bool Exhaust(EErrorCode Code, ErrorManager& Errors, int32_t Start, int32_t End);
+
+	const EvaluationLimits Limits;
+	const CancelToken* Cancel;
+	std::chrono::steady_clock::time_point Deadline;
+
+	uint64_t OperationCount = 0;
+	uint64_t NextCheck = 0;
+	uint32_t NodeCount = 0;
+	bool Exhausted = false;
+};
@@ -0,0 +1,59 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "EvaluationContext.h"
+#include "Interpreter/DirectEvaluator.h"
+#include "Interpreter/Interpreter.h"
+#include "Parser/Parser.h"
+
+EvaluationContext::EvaluationContext(const EvaluationLimits& Limits, const CancelToken* Cancel, std::pmr::memory_resource* Resource)
+	: Limits(Limits),
+	  Cancel(Cancel),
+	  Tree(Resource),
+	  Errors(Resource),
+	  Scratch(Resource)
+{
+}
+
+void EvaluationContext::Reserve(const size_t MaxInputLength)
+{
+	// Every token is at most one node plus one error node for a missing operand after it, every error is
+	// reported at a token or at a bracket left open, and there is one token per character at most
+	const size_t TokenCount = MaxInputLength + 1;
+
+	Tree.Reserve(2 * TokenCount + 1, TokenCount);
+	Errors.Reserve(2 * TokenCount + 2);
+
+	// A flattened sum holds at most one term and one value per node
+	Scratch.Reserve(2 * TokenCount + 1);
+}
+
+Number EvaluationContext::Evaluate(const std::string_view Input)
+{
+	Number Result;
+	Errors.Clear();
+
+	EvaluationBudget Budget(Limits, Cancel);
+
+	if (!Budget.CheckInputLength(Input.size(), Errors))
+	{
+		return Result;
+	}
+
+	// Same order as the UI, the full pipeline only runs for input the direct evaluator rejects. The direct
+	// evaluator always adds left to right, so it is skipped when another sum mode was asked for.
+	if (SumMode == SUM_MODE_STRICT && DirectEvaluator::TryEvaluate(Input, Result, Errors))
+	{
+		return Result;
+	}
+
+	Tree.Clear();
+	const uint32_t Root = Parser::GetExpressionResult(Input, Tree, Errors, &Budget);
+
+	if (!Errors.HasErrors())
+	{
+		Result = Interpreter::Visit(Tree, Root, Errors, SumMode, Scratch, &Budget);
+	}
+
+	return Result;
+}
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/Summation.h"
+#include "Parser/NodeTypes.h"
+
+/*
+ * Everything one evaluation needs, kept between evaluations so a caller that evaluates many formulas (a server
+ * worker, a spreadsheet recalculation) stops allocating once its buffers have grown:
+ *
+ *		EvaluationContext Context(Limits);
+ *		Context.Reserve(4096);
+ *
+ *		const Number Result = Context.Evaluate(Formula);
+ *
+ * Tokens are pulled from the lexer and never stored, literals are parsed in place and nodes go into the reused
+ * pool, so after Reserve(MaxInputLength) no input of up to MaxInputLength characters touches the heap, in every
+ * sum mode. Number literals longer than 127 characters that contain '_' or overflow are the only exception.
+ */
+class EvaluationContext
+{
+public:
+	// The node pool and the error list are allocated from Resource
+	explicit EvaluationContext(const EvaluationLimits& Limits = {},
+	                           const CancelToken* Cancel = nullptr,
+	                           std::pmr::memory_resource* Resource = std::pmr::get_default_resource());
+
+	// Sizes the node pool and the error list for inputs of up to MaxInputLength characters
+	void Reserve(size_t MaxInputLength);
+
+	// Result of Input, its errors stay available from GetErrors() until the next call
+	Number Evaluate(std::string_view Input);
+
+	[[nodiscard]] const ErrorManager& GetErrors() const
+	{
+		return Errors;
+	}
+
+	// Long '+'/'-' chains of the following evaluations are summed in SumMode, see Interpreter::Visit
+	void SetSumMode(const ESumMode InSumMode)
+	{
+		SumMode = InSumMode;
+	}
+
+	// Protected fields and functions
+protected:
+	const EvaluationLimits Limits;
+	const CancelToken* Cancel;
+	ESumMode SumMode = SUM_MODE_STRICT;
+
+	SyntaxTree Tree;
+	ErrorManager Errors;
+	Interpreter::SumScratch Scratch;
+};
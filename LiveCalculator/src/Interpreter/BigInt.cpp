@@ -0,0 +1,335 @@
+﻿#include "Pch.h"
+
+#include "BigInt.h"
+
+BigInt::BigInt(const int64_t Value)
+	: Negative(Value < 0)
+{
+	// Through uint64_t so INT64_MIN does not overflow
+	uint64_t Absolute = Value < 0 ? 0 - static_cast<uint64_t>(Value) : static_cast<uint64_t>(Value);
+
+	while (Absolute != 0)
+	{
+		Limbs.push_back(static_cast<uint32_t>(Absolute));
+		Absolute >>= 32;
+	}
+}
+
+[[nodiscard]] bool BigInt::FitsInt64() const
+{
+	if (Limbs.size() > 2)
+	{
+		return false;
+	}
+
+	const uint64_t Absolute = Limbs.empty() ? 0 : Limbs[0] | (Limbs.size() == 2 ? static_cast<uint64_t>(Limbs[1]) << 32 : 0);
+	return Absolute <= (Negative ? static_cast<uint64_t>(INT64_MAX) + 1 : static_cast<uint64_t>(INT64_MAX));
+}
+
+[[nodiscard]] int64_t BigInt::ToInt64() const
+{
+	const uint64_t Absolute = Limbs.empty() ? 0 : Limbs[0] | (Limbs.size() == 2 ? static_cast<uint64_t>(Limbs[1]) << 32 : 0);
+	return Negative ? static_cast<int64_t>(0 - Absolute) : static_cast<int64_t>(Absolute);
+}
+
+[[nodiscard]] long double BigInt::ToLongDouble() const
+{
+	long double Result = 0.0L;
+
+	for (size_t Index = Limbs.size(); Index > 0; --Index)
+	{
+		Result = Result * 4294967296.0L + static_cast<long double>(Limbs[Index - 1]);
+	}
+
+	return Negative ? -Result : Result;
+}
+
+[[nodiscard]] std::string BigInt::ToString() const
+{
+	if (IsZero())
+	{
+		return "0";
+	}
+
+	// Nine decimal digits at a time
+	Magnitude Value = Limbs;
+	std::vector<uint32_t> Groups;
+
+	while (!Value.empty())
+	{
+		Groups.push_back(DivideMagnitudeBySmall(Value, 1000000000));
+	}
+
+	std::string Result = Negative ? "-" : "";
+	Result += std::to_string(Groups.back());
+
+	for (size_t Index = Groups.size() - 1; Index > 0; --Index)
+	{
+		const std::string Group = std::to_string(Groups[Index - 1]);
+		Result.append(9 - Group.size(), '0');
+		Result += Group;
+	}
+
+	return Result;
+}
+
+[[nodiscard]] uint32_t BigInt::GetBitLength() const
+{
+	if (IsZero())
+	{
+		return 0;
+	}
+
+	return static_cast<uint32_t>(Limbs.size() - 1) * 32 + static_cast<uint32_t>(std::bit_width(Limbs.back()));
+}
+
+[[nodiscard]] BigInt BigInt::AddedTo(const BigInt& Other) const
+{
+	if (Negative == Other.Negative)
+	{
+		return FromMagnitude(AddMagnitude(Limbs, Other.Limbs), Negative);
+	}
+
+	// Different signs, subtract the smaller magnitude from the larger one
+	if (CompareMagnitude(Limbs, Other.Limbs) >= 0)
+	{
+		return FromMagnitude(SubtractMagnitude(Limbs, Other.Limbs), Negative);
+	}
+
+	return FromMagnitude(SubtractMagnitude(Other.Limbs, Limbs), Other.Negative);
+}
+
+[[nodiscard]] BigInt BigInt::SubtractedBy(const BigInt& Other) const
+{
+	return AddedTo(Other.Negated());
+}
+
+[[nodiscard]] BigInt BigInt::MultipliedBy(const BigInt& Other) const
+{
+	return FromMagnitude(MultiplyMagnitude(Limbs, Other.Limbs), Negative != Other.Negative);
+}
+
+[[nodiscard]] BigInt BigInt::DividedBy(const BigInt& Other) const
+{
+	Magnitude Remainder;
+	return FromMagnitude(DivideMagnitude(Limbs, Other.Limbs, Remainder), Negative != Other.Negative);
+}
+
+[[nodiscard]] BigInt BigInt::RemainderOf(const BigInt& Other) const
+{
+	Magnitude Remainder;
+	(void)DivideMagnitude(Limbs, Other.Limbs, Remainder);
+	return FromMagnitude(std::move(Remainder), Negative);
+}
+
+[[nodiscard]] BigInt BigInt::Negated() const
+{
+	return FromMagnitude(Limbs, !Negative);
+}
+
+[[nodiscard]] BigInt BigInt::Absolute() const
+{
+	return FromMagnitude(Limbs, false);
+}
+
+[[nodiscard]] BigInt BigInt::ShiftedRight(const uint32_t Bits) const
+{
+	const size_t LimbShift = Bits / 32;
+	const uint32_t BitShift = Bits % 32;
+
+	if (LimbShift >= Limbs.size())
+	{
+		return {};
+	}
+
+	Magnitude Result(Limbs.size() - LimbShift);
+
+	for (size_t Index = 0; Index < Result.size(); ++Index)
+	{
+		const uint64_t Low = Limbs[Index + LimbShift];
+		const uint64_t High = Index + LimbShift + 1 < Limbs.size() ? Limbs[Index + LimbShift + 1] : 0;
+		Result[Index] = static_cast<uint32_t>(((High << 32) | Low) >> BitShift);
+	}
+
+	return FromMagnitude(std::move(Result), Negative);
+}
+
+[[nodiscard]] BigInt BigInt::Gcd(BigInt Left, BigInt Right)
+{
+	Left = Left.Absolute();
+	Right = Right.Absolute();
+
+	while (!Right.IsZero())
+	{
+		BigInt Remainder = Left.RemainderOf(Right);
+		Left = std::move(Right);
+		Right = std::move(Remainder);
+	}
+
+	return Left;
+}
+
+[[nodiscard]] int32_t BigInt::Compare(const BigInt& Left, const BigInt& Right)
+{
+	if (Left.Negative != Right.Negative)
+	{
+		return Left.Negative ? -1 : 1;
+	}
+
+	const int32_t Result = CompareMagnitude(Left.Limbs, Right.Limbs);
+	return Left.Negative ? -Result : Result;
+}
+
+int32_t BigInt::CompareMagnitude(const Magnitude& Left, const Magnitude& Right)
+{
+	if (Left.size() != Right.size())
+	{
+		return Left.size() < Right.size() ? -1 : 1;
+	}
+
+	for (size_t Index = Left.size(); Index > 0; --Index)
+	{
+		if (Left[Index - 1] != Right[Index - 1])
+		{
+			return Left[Index - 1] < Right[Index - 1] ? -1 : 1;
+		}
+	}
+
+	return 0;
+}
+
+BigInt::Magnitude BigInt::AddMagnitude(const Magnitude& Left, const Magnitude& Right)
+{
+	Magnitude Result(std::max(Left.size(), Right.size()) + 1);
+	uint64_t Carry = 0;
+
+	for (size_t Index = 0; Index < Result.size(); ++Index)
+	{
+		const uint64_t Sum = Carry + (Index < Left.size() ? Left[Index] : 0) + (Index < Right.size() ? Right[Index] : 0);
+		Result[Index] = static_cast<uint32_t>(Sum);
+		Carry = Sum >> 32;
+	}
+
+	Trim(Result);
+	return Result;
+}
+
+BigInt::Magnitude BigInt::SubtractMagnitude(const Magnitude& Left, const Magnitude& Right)
+{
+	Magnitude Result(Left.size());
+	int64_t Borrow = 0;
+
+	for (size_t Index = 0; Index < Left.size(); ++Index)
+	{
+		int64_t Difference = static_cast<int64_t>(Left[Index]) - Borrow - (Index < Right.size() ? Right[Index] : 0);
+		Borrow = Difference < 0 ? 1 : 0;
+		Difference += Borrow << 32;
+		Result[Index] = static_cast<uint32_t>(Difference);
+	}
+
+	Trim(Result);
+	return Result;
+}
+
+BigInt::Magnitude BigInt::MultiplyMagnitude(const Magnitude& Left, const Magnitude& Right)
+{
+	if (Left.empty() || Right.empty())
+	{
+		return {};
+	}
+
+	Magnitude Result(Left.size() + Right.size());
+
+	for (size_t LeftIndex = 0; LeftIndex < Left.size(); ++LeftIndex)
+	{
+		uint64_t Carry = 0;
+
+		for (size_t RightIndex = 0; RightIndex < Right.size(); ++RightIndex)
+		{
+			const uint64_t Product = static_cast<uint64_t>(Left[LeftIndex]) * Right[RightIndex] + Result[LeftIndex + RightIndex] + Carry;
+			Result[LeftIndex + RightIndex] = static_cast<uint32_t>(Product);
+			Carry = Product >> 32;
+		}
+
+		Result[LeftIndex + Right.size()] = static_cast<uint32_t>(Carry);
+	}
+
+	Trim(Result);
+	return Result;
+}
+
+// Shift and subtract, one quotient bit per step. Big values only appear after int64 overflow so this stays rare.
+BigInt::Magnitude BigInt::DivideMagnitude(const Magnitude& Left, const Magnitude& Right, Magnitude& OutRemainder)
+{
+	if (Right.size() == 1)
+	{
+		Magnitude Quotient = Left;
+		const uint32_t Remainder = DivideMagnitudeBySmall(Quotient, Right[0]);
+		OutRemainder = Remainder != 0 ? Magnitude{ Remainder } : Magnitude{};
+		return Quotient;
+	}
+
+	Magnitude Quotient(Left.size());
+	OutRemainder.clear();
+
+	for (size_t Bit = Left.size() * 32; Bit > 0; --Bit)
+	{
+		// Remainder = Remainder * 2 + next bit
+		uint32_t Carry = (Left[(Bit - 1) / 32] >> ((Bit - 1) % 32)) & 1;
+
+		for (uint32_t& Limb : OutRemainder)
+		{
+			const uint32_t NextCarry = Limb >> 31;
+			Limb = (Limb << 1) | Carry;
+			Carry = NextCarry;
+		}
+
+		if (Carry != 0)
+		{
+			OutRemainder.push_back(Carry);
+		}
+
+		if (CompareMagnitude(OutRemainder, Right) >= 0)
+		{
+			OutRemainder = SubtractMagnitude(OutRemainder, Right);
+			Quotient[(Bit - 1) / 32] |= 1u << ((Bit - 1) % 32);
+		}
+	}
+
+	Trim(Quotient);
+	return Quotient;
+}
+
+uint32_t BigInt::DivideMagnitudeBySmall(Magnitude& Value, const uint32_t Divisor)
+{
+	uint64_t Remainder = 0;
+
+	for (size_t Index = Value.size(); Index > 0; --Index)
+	{
+		const uint64_t Current = (Remainder << 32) | Value[Index - 1];
+		Value[Index - 1] = static_cast<uint32_t>(Current / Divisor);
+		Remainder = Current % Divisor;
+	}
+
+	Trim(Value);
+	return static_cast<uint32_t>(Remainder);
+}
+
+void BigInt::Trim(Magnitude& Value)
+{
+	while (!Value.empty() && Value.back() == 0)
+	{
+		Value.pop_back();
+	}
+}
+
+BigInt BigInt::FromMagnitude(Magnitude Value, const bool Negative)
+{
+	BigInt Result;
+	Result.Limbs = std::move(Value);
+	Trim(Result.Limbs);
+
+	// No negative zero
+	Result.Negative = Negative && !Result.Limbs.empty();
+	return Result;
+}
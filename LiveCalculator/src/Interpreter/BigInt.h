@@ -0,0 +1,65 @@
+﻿#pragma once
+
+// Arbitrary precision integer for Rational, sign and magnitude with 32-bit limbs, least significant first
+class BigInt
+{
+	// Access functions
+public:
+	// Zero
+	BigInt() = default;
+
+	explicit BigInt(int64_t Value);
+
+	[[nodiscard]] bool IsZero() const
+	{
+		return Limbs.empty();
+	}
+
+	[[nodiscard]] bool IsNegative() const
+	{
+		return Negative;
+	}
+
+	[[nodiscard]] bool FitsInt64() const;
+	[[nodiscard]] int64_t ToInt64() const;
+	[[nodiscard]] long double ToLongDouble() const;
+	[[nodiscard]] std::string ToString() const;
+	[[nodiscard]] uint32_t GetBitLength() const;
+
+	[[nodiscard]] BigInt AddedTo(const BigInt& Other) const;
+	[[nodiscard]] BigInt SubtractedBy(const BigInt& Other) const;
+	[[nodiscard]] BigInt MultipliedBy(const BigInt& Other) const;
+
+	// Truncates towards zero like int64_t division, Other must not be zero
+	[[nodiscard]] BigInt DividedBy(const BigInt& Other) const;
+	[[nodiscard]] BigInt RemainderOf(const BigInt& Other) const;
+
+	[[nodiscard]] BigInt Negated() const;
+	[[nodiscard]] BigInt Absolute() const;
+	[[nodiscard]] BigInt ShiftedRight(uint32_t Bits) const;
+
+	// Always non-negative
+	[[nodiscard]] static BigInt Gcd(BigInt Left, BigInt Right);
+
+	// -1, 0 or 1
+	[[nodiscard]] static int32_t Compare(const BigInt& Left, const BigInt& Right);
+
+	// Protected fields and functions
+protected:
+	using Magnitude = std::vector<uint32_t>;
+
+	static int32_t CompareMagnitude(const Magnitude& Left, const Magnitude& Right);
+	static Magnitude AddMagnitude(const Magnitude& Left, const Magnitude& Right);
+
+	// Left must not be smaller than Right
+	static Magnitude SubtractMagnitude(const Magnitude& Left, const Magnitude& Right);
+	static Magnitude MultiplyMagnitude(const Magnitude& Left, const Magnitude& Right);
+	static Magnitude DivideMagnitude(const Magnitude& Left, const Magnitude& Right, Magnitude& OutRemainder);
+	static uint32_t DivideMagnitudeBySmall(Magnitude& Value, uint32_t Divisor);
+	static void Trim(Magnitude& Value);
+
+	static BigInt FromMagnitude(Magnitude Value, bool Negative);
+
+	bool Negative = false;
+	Magnitude Limbs;
+};
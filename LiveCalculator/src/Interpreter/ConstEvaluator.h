@@ -0,0 +1,723 @@
+﻿#pragma once
+
+#include "../ErrorManager.h"
+#include "../Parser/NodeTypes.h"
+#include "Number.h"
+
+/*
+ * Compile-time front end. Lexes, parses and evaluates a formula during constant evaluation using the same
+ * grammar as Lexer/Parser and the same Number promotion rules as the Interpreter:
+ *
+ *		constexpr Number Value = LiveCalc::Eval<"2*(3+4)">();
+ *
+ * The first error the runtime pipeline would report fails the build instead, the compiler diagnostic
+ * names the error (e.g. "call to non-constexpr function 'LiveCalc::Detail::ExpectedRightBracket()'").
+ *
+ * Float literals are rounded to nearest like the lexer does (see ParseFloat), so a literal gives the same bits
+ * here as at runtime whatever its length or exponent.
+ */
+namespace LiveCalc
+{
+	template <size_t Length>
+	struct FixedString
+	{
+		consteval FixedString(const char (&Input)[Length])
+		{
+			std::copy_n(Input, Length, Data);
+		}
+
+		[[nodiscard]] constexpr std::string_view View() const
+		{
+			return { Data, Length - 1 };
+		}
+
+		char Data[Length]{};
+	};
+
+	namespace Detail
+	{
+		// Not constexpr on purpose. Reaching one of these during constant evaluation is a compile error.
+		inline void IllegalCharacter() {}
+		inline void ExpectedOperator() {}
+		inline void ExpectedRightBracket() {}
+		inline void ExpectedNumber() {}
+		inline void DivisionByZero() {}
+
+		constexpr void ReportError(const EErrorCode Code)
+		{
+			switch (Code)
+			{
+			case ERROR_ILLEGAL_CHARACTER:
+				IllegalCharacter();
+				break;
+
+			case ERROR_EXPECTED_OPERATOR:
+				ExpectedOperator();
+				break;
+
+			case ERROR_EXPECTED_RBRACKET:
+				ExpectedRightBracket();
+				break;
+
+			case ERROR_EXPECTED_NUMBER:
+				ExpectedNumber();
+				break;
+
+			case ERROR_DIVISION_BY_ZERO:
+				DivisionByZero();
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		constexpr bool IsDigit(const char Character)
+		{
+			return Character >= '0' && Character <= '9';
+		}
+
+		constexpr bool IsHexDigit(const char Character)
+		{
+			return IsDigit(Character) || (Character >= 'a' && Character <= 'f') || (Character >= 'A' && Character <= 'F');
+		}
+
+		constexpr int64_t GetDigitValue(const char Character)
+		{
+			if (IsDigit(Character))
+			{
+				return Character - '0';
+			}
+
+			return (Character >= 'a' ? Character - 'a' : Character - 'A') + 10;
+		}
+
+		// Saturates on overflow like strtoll, skips '_' separators
+		constexpr int64_t ParseInt(const std::string_view Digits, const int64_t Base)
+		{
+			int64_t Value = 0;
+
+			for (const char Character : Digits)
+			{
+				if (Character == '_')
+				{
+					continue;
+				}
+
+				const int64_t Digit = GetDigitValue(Character);
+
+				if (Value > (INT64_MAX - Digit) / Base)
+				{
+					return INT64_MAX;
+				}
+
+				Value = Value * Base + Digit;
+			}
+
+			return Value;
+		}
+
+		// Unsigned integer of any size for ParseFloat, 32-bit limbs from least to most significant without leading zero limbs
+		class ConstBigInt
+		{
+		public:
+			constexpr ConstBigInt() = default;
+
+			constexpr explicit ConstBigInt(const uint32_t Value)
+			{
+				MultiplyAdd(0, Value);
+			}
+
+			// this = this * Factor + Addend
+			constexpr void MultiplyAdd(const uint32_t Factor, const uint32_t Addend)
+			{
+				uint64_t Carry = Addend;
+
+				for (uint32_t& Limb : Limbs)
+				{
+					const uint64_t Product = static_cast<uint64_t>(Limb) * Factor + Carry;
+					Limb = static_cast<uint32_t>(Product);
+					Carry = Product >> 32;
+				}
+
+				if (Carry != 0)
+				{
+					Limbs.push_back(static_cast<uint32_t>(Carry));
+				}
+
+				Trim();
+			}
+
+			constexpr void MultiplyByPowerOfTen(int32_t Power)
+			{
+				for (; Power >= 9; Power -= 9)
+				{
+					MultiplyAdd(1000000000, 0);
+				}
+
+				uint32_t Factor = 1;
+
+				for (; Power > 0; --Power)
+				{
+					Factor *= 10;
+				}
+
+				MultiplyAdd(Factor, 0);
+			}
+
+			constexpr void ShiftLeft(const int32_t Count)
+			{
+				const int32_t LimbShift = Count / 32;
+				const int32_t BitShift = Count % 32;
+
+				if (IsZero() || Count == 0)
+				{
+					return;
+				}
+
+				if (BitShift != 0)
+				{
+					uint32_t Carry = 0;
+
+					for (uint32_t& Limb : Limbs)
+					{
+						const uint32_t Shifted = Limb << BitShift | Carry;
+						Carry = Limb >> (32 - BitShift);
+						Limb = Shifted;
+					}
+
+					if (Carry != 0)
+					{
+						Limbs.push_back(Carry);
+					}
+				}
+
+				Limbs.insert(Limbs.begin(), static_cast<size_t>(LimbShift), 0);
+			}
+
+			[[nodiscard]] constexpr ConstBigInt ShiftedLeft(const int32_t Count) const
+			{
+				ConstBigInt Result = *this;
+				Result.ShiftLeft(Count);
+				return Result;
+			}
+
+			constexpr void ShiftRightByOne()
+			{
+				for (size_t Index = 0; Index < Limbs.size(); ++Index)
+				{
+					const uint32_t Next = Index + 1 < Limbs.size() ? Limbs[Index + 1] : 0;
+					Limbs[Index] = Limbs[Index] >> 1 | Next << 31;
+				}
+
+				Trim();
+			}
+
+			// Other must not be larger than this
+			constexpr void Subtract(const ConstBigInt& Other)
+			{
+				int64_t Borrow = 0;
+
+				for (size_t Index = 0; Index < Limbs.size(); ++Index)
+				{
+					int64_t Difference = static_cast<int64_t>(Limbs[Index]) - Borrow - (Index < Other.Limbs.size() ? Other.Limbs[Index] : 0);
+					Borrow = Difference < 0 ? 1 : 0;
+					Limbs[Index] = static_cast<uint32_t>(Difference + (Borrow << 32));
+				}
+
+				Trim();
+			}
+
+			[[nodiscard]] constexpr int32_t Compare(const ConstBigInt& Other) const
+			{
+				if (Limbs.size() != Other.Limbs.size())
+				{
+					return Limbs.size() < Other.Limbs.size() ? -1 : 1;
+				}
+
+				for (size_t Index = Limbs.size(); Index-- > 0;)
+				{
+					if (Limbs[Index] != Other.Limbs[Index])
+					{
+						return Limbs[Index] < Other.Limbs[Index] ? -1 : 1;
+					}
+				}
+
+				return 0;
+			}
+
+			[[nodiscard]] constexpr int32_t GetBitLength() const
+			{
+				return IsZero() ? 0 : static_cast<int32_t>(Limbs.size() * 32 - std::countl_zero(Limbs.back()));
+			}
+
+			[[nodiscard]] constexpr bool IsZero() const
+			{
+				return Limbs.empty();
+			}
+
+		private:
+			constexpr void Trim()
+			{
+				while (!Limbs.empty() && Limbs.back() == 0)
+				{
+					Limbs.pop_back();
+				}
+			}
+
+			std::vector<uint32_t> Limbs;
+		};
+
+		// Value * 2^Power, every step is exact as long as the result is representable
+		template <typename T>
+		constexpr T ScaleByPowerOfTwo(T Value, int32_t Power)
+		{
+			for (; Power >= 32; Power -= 32)
+			{
+				Value *= static_cast<T>(4294967296.0);
+			}
+
+			for (; Power <= -32; Power += 32)
+			{
+				Value /= static_cast<T>(4294967296.0);
+			}
+
+			for (; Power > 0; --Power)
+			{
+				Value *= 2;
+			}
+
+			for (; Power < 0; ++Power)
+			{
+				Value /= 2;
+			}
+
+			return Value;
+		}
+
+		/*
+		 * Correctly rounded (to nearest, ties to even) like the strtod family the lexer uses. The literal is read
+		 * as Numerator / Denominator with both scaled by powers of ten, the quotient is taken to as many bits as T
+		 * has (fewer for subnormals) by long division and the remainder decides the rounding.
+		 */
+		template <typename T>
+		constexpr T ParseFloat(const std::string_view Digits)
+		{
+			using Limits = std::numeric_limits<T>;
+
+			static_assert(Limits::radix == 2, "ParseFloat expects a binary floating-point type");
+			static_assert(Limits::digits <= 64, "The quotient has to fit into 64 bits");
+
+			ConstBigInt Numerator;
+			int32_t SignificantDigits = 0;
+			int32_t Exponent = 0;
+			bool IsFraction = false;
+			size_t Index = 0;
+
+			for (; Index < Digits.size() && Digits[Index] != 'e' && Digits[Index] != 'E'; ++Index)
+			{
+				const char Character = Digits[Index];
+
+				if (Character == '_')
+				{
+					continue;
+				}
+
+				if (Character == '.')
+				{
+					IsFraction = true;
+					continue;
+				}
+
+				if (IsFraction)
+				{
+					Exponent--;
+				}
+
+				// Leading zeros are not significant
+				if (Numerator.IsZero() && Character == '0')
+				{
+					continue;
+				}
+
+				Numerator.MultiplyAdd(10, static_cast<uint32_t>(Character - '0'));
+				SignificantDigits++;
+			}
+
+			if (Index < Digits.size())
+			{
+				const bool IsNegative = Digits[++Index] == '-';
+				int32_t WrittenExponent = 0;
+
+				for (; Index < Digits.size(); ++Index)
+				{
+					if (IsDigit(Digits[Index]))
+					{
+						// Anything past this is infinity or zero anyway
+						WrittenExponent = std::min(WrittenExponent * 10 + Digits[Index] - '0', 100000);
+					}
+				}
+
+				Exponent += IsNegative ? -WrittenExponent : WrittenExponent;
+			}
+
+			if (Numerator.IsZero())
+			{
+				return static_cast<T>(0);
+			}
+
+			// 10^(DecimalMagnitude - 1) <= value < 10^DecimalMagnitude
+			const int32_t DecimalMagnitude = SignificantDigits + Exponent;
+
+			if (DecimalMagnitude - 1 > Limits::max_exponent10)
+			{
+				return Limits::infinity();
+			}
+
+			// Less than half of the smallest subnormal
+			if (DecimalMagnitude < Limits::min_exponent10 - Limits::max_digits10 - 1)
+			{
+				return static_cast<T>(0);
+			}
+
+			ConstBigInt Denominator(1);
+
+			if (Exponent > 0)
+			{
+				Numerator.MultiplyByPowerOfTen(Exponent);
+			}
+			else
+			{
+				Denominator.MultiplyByPowerOfTen(-Exponent);
+			}
+
+			// 2^BinaryExponent <= Numerator / Denominator < 2^(BinaryExponent + 1)
+			int32_t BinaryExponent = Numerator.GetBitLength() - Denominator.GetBitLength();
+
+			if (BinaryExponent >= 0 ? Numerator.Compare(Denominator.ShiftedLeft(BinaryExponent)) < 0 : Numerator.ShiftedLeft(-BinaryExponent).Compare(Denominator) < 0)
+			{
+				BinaryExponent--;
+			}
+
+			// Subnormals keep fewer bits, their exponent is fixed at the smallest normal one
+			const int32_t Shift = Limits::digits - 1 - std::max(BinaryExponent, Limits::min_exponent - 1);
+
+			if (Shift >= 0)
+			{
+				Numerator.ShiftLeft(Shift);
+			}
+			else
+			{
+				Denominator.ShiftLeft(-Shift);
+			}
+
+			// Numerator / Denominator < 2^digits now, one quotient bit at a time leaves the remainder in Numerator
+			uint64_t Quotient = 0;
+			ConstBigInt Step = Denominator.ShiftedLeft(Limits::digits - 1);
+
+			for (int32_t Bit = Limits::digits - 1; Bit >= 0; --Bit)
+			{
+				if (Numerator.Compare(Step) >= 0)
+				{
+					Numerator.Subtract(Step);
+					Quotient |= uint64_t{ 1 } << Bit;
+				}
+
+				Step.ShiftRightByOne();
+			}
+
+			Numerator.ShiftLeft(1);
+			const int32_t Half = Numerator.Compare(Denominator);
+			int32_t ResultShift = Shift;
+
+			if (Half > 0 || (Half == 0 && (Quotient & 1) != 0))
+			{
+				constexpr uint64_t LARGEST_QUOTIENT = Limits::digits == 64 ? UINT64_MAX : (uint64_t{ 1 } << Limits::digits) - 1;
+
+				if (Quotient == LARGEST_QUOTIENT)
+				{
+					// Rounds up to the next power of two
+					Quotient = uint64_t{ 1 } << (Limits::digits - 1);
+					ResultShift--;
+				}
+				else
+				{
+					Quotient++;
+				}
+			}
+
+			// Too large for T after rounding, becomes infinity as the runtime lexer reads it
+			if (Limits::digits - 1 - ResultShift >= Limits::max_exponent)
+			{
+				return Limits::infinity();
+			}
+
+			return ScaleByPowerOfTwo(static_cast<T>(Quotient), -ResultShift);
+		}
+
+		struct ConstToken
+		{
+			ETokenType Type = TYPE_EOF;
+			Number Value = Number(int64_t{ 0 });
+		};
+
+		struct ConstNode
+		{
+			ENodeType Type = NODE_TYPE_NUMBER;
+			ETokenType Operator = TYPE_EOF;
+			size_t Left = 0;
+			size_t Right = 0;
+			Number Value = Number(int64_t{ 0 });
+		};
+
+		// Mirrors Lexer, Parser and Interpreter. A formula of N characters never needs more than N tokens or nodes.
+		template <size_t Capacity>
+		class ConstEvaluator
+		{
+		public:
+			constexpr explicit ConstEvaluator(const std::string_view Input)
+				: Input(Input)
+			{
+			}
+
+			constexpr Number Run()
+			{
+				GetTokens();
+
+				const size_t Root = GetExpression();
+
+				if (Tokens[TokenIndex].Type != TYPE_EOF)
+				{
+					ReportError(ERROR_EXPECTED_OPERATOR);
+				}
+
+				return Visit(Root);
+			}
+
+		private:
+			constexpr void GetTokens()
+			{
+				size_t Index = 0;
+
+				while (Index < Input.size())
+				{
+					const char Character = Input[Index];
+
+					if (Character == ' ' || Character == '\t')
+					{
+						Index++;
+					}
+					else if (IsDigit(Character))
+					{
+						const size_t Start = Index;
+
+						if (Character == '0' && (GetCharacter(Index + 1) == 'x' || GetCharacter(Index + 1) == 'X') && IsHexDigit(GetCharacter(Index + 2)))
+						{
+							Index = SkipDigits(Index + 2, IsHexDigit);
+							Tokens[TokenCount++] = { TYPE_INT, Number(ParseInt(Input.substr(Start + 2, Index - Start - 2), 16)) };
+							continue;
+						}
+
+						bool IsFloat = false;
+						Index = SkipDigits(Index, IsDigit);
+
+						if (GetCharacter(Index) == '.')
+						{
+							IsFloat = true;
+							Index++;
+
+							if (IsDigit(GetCharacter(Index)))
+							{
+								Index = SkipDigits(Index, IsDigit);
+							}
+						}
+
+						if (GetCharacter(Index) == 'e' || GetCharacter(Index) == 'E')
+						{
+							const char Next = GetCharacter(Index + 1);
+
+							if (IsDigit(Next) || ((Next == '+' || Next == '-') && IsDigit(GetCharacter(Index + 2))))
+							{
+								IsFloat = true;
+								Index = SkipDigits(IsDigit(Next) ? Index + 1 : Index + 2, IsDigit);
+							}
+						}
+
+						const std::string_view Digits = Input.substr(Start, Index - Start);
+
+						if (IsFloat)
+						{
+							Tokens[TokenCount++] = { TYPE_FLOAT, Number(ParseFloat<Number::FloatType>(Digits)) };
+						}
+						else
+						{
+							Tokens[TokenCount++] = { TYPE_INT, Number(ParseInt(Digits, 10)) };
+						}
+					}
+					else
+					{
+						ETokenType Type = TYPE_EOF;
+
+						switch (Character)
+						{
+						case '+': Type = TYPE_PLUS; break;
+						case '-': Type = TYPE_MINUS; break;
+						case '*': Type = TYPE_MUL; break;
+						case '/': Type = TYPE_DIV; break;
+						case '(': Type = TYPE_LBRACKET; break;
+						case ')': Type = TYPE_RBRACKET; break;
+						default: ReportError(ERROR_ILLEGAL_CHARACTER); break;
+						}
+
+						Tokens[TokenCount++] = { Type };
+						Index++;
+					}
+				}
+
+				Tokens[TokenCount++] = { TYPE_EOF };
+			}
+
+			constexpr char GetCharacter(const size_t Index) const
+			{
+				return Index < Input.size() ? Input[Index] : '\0';
+			}
+
+			// Same rules as Lexer::SkipDigits, '_' only between two digits
+			constexpr size_t SkipDigits(size_t Index, bool (*IsDigitCharacter)(char)) const
+			{
+				while (IsDigitCharacter(GetCharacter(Index)) || (GetCharacter(Index) == '_' && IsDigitCharacter(GetCharacter(Index + 1))))
+				{
+					Index++;
+				}
+
+				return Index;
+			}
+
+			constexpr size_t CreateNode(const ConstNode& Node)
+			{
+				Nodes[NodeCount] = Node;
+				return NodeCount++;
+			}
+
+			constexpr size_t GetFactor()
+			{
+				const ConstToken& SavedToken = Tokens[TokenIndex];
+
+				if (SavedToken.Type == TYPE_PLUS || SavedToken.Type == TYPE_MINUS)
+				{
+					TokenIndex++;
+					const size_t Factor = GetFactor();
+					return CreateNode({ NODE_TYPE_UNARY_OP, SavedToken.Type, Factor });
+				}
+
+				if (SavedToken.Type == TYPE_INT || SavedToken.Type == TYPE_FLOAT)
+				{
+					TokenIndex++;
+					return CreateNode({ NODE_TYPE_NUMBER, SavedToken.Type, 0, 0, SavedToken.Value });
+				}
+
+				if (SavedToken.Type == TYPE_LBRACKET)
+				{
+					TokenIndex++;
+					const size_t Expression = GetExpression();
+
+					if (Tokens[TokenIndex].Type != TYPE_RBRACKET)
+					{
+						ReportError(ERROR_EXPECTED_RBRACKET);
+					}
+
+					TokenIndex++;
+					return Expression;
+				}
+
+				ReportError(ERROR_EXPECTED_NUMBER);
+				return 0;
+			}
+
+			constexpr size_t GetTerm()
+			{
+				size_t Left = GetFactor();
+
+				while (Tokens[TokenIndex].Type == TYPE_MUL || Tokens[TokenIndex].Type == TYPE_DIV)
+				{
+					const ETokenType Operator = Tokens[TokenIndex++].Type;
+					const size_t Right = GetFactor();
+					Left = CreateNode({ NODE_TYPE_BINARY_OP, Operator, Left, Right });
+				}
+
+				return Left;
+			}
+
+			constexpr size_t GetExpression()
+			{
+				size_t Left = GetTerm();
+
+				while (Tokens[TokenIndex].Type == TYPE_PLUS || Tokens[TokenIndex].Type == TYPE_MINUS)
+				{
+					const ETokenType Operator = Tokens[TokenIndex++].Type;
+					const size_t Right = GetTerm();
+					Left = CreateNode({ NODE_TYPE_BINARY_OP, Operator, Left, Right });
+				}
+
+				return Left;
+			}
+
+			constexpr Number Visit(const size_t NodeIndex) const
+			{
+				const ConstNode& Node = Nodes[NodeIndex];
+
+				if (Node.Type == NODE_TYPE_NUMBER)
+				{
+					return Node.Value;
+				}
+
+				if (Node.Type == NODE_TYPE_UNARY_OP)
+				{
+					const Number Child = Visit(Node.Left);
+					return Node.Operator == TYPE_MINUS ? Child.MultipliedBy(Number(int64_t{ -1 })) : Child;
+				}
+
+				const Number Left = Visit(Node.Left);
+				const Number Right = Visit(Node.Right);
+
+				switch (Node.Operator)
+				{
+				case TYPE_PLUS:
+					return Left.AddedTo(Right);
+
+				case TYPE_MINUS:
+					return Left.SubtractedBy(Right);
+
+				case TYPE_MUL:
+					return Left.MultipliedBy(Right);
+
+				case TYPE_DIV:
+					if ((Right.IsInt && Right.IntValue == 0) || (!Right.IsInt && Right.FloatValue == 0.0))
+					{
+						ReportError(ERROR_DIVISION_BY_ZERO);
+					}
+
+					return Left.DividedBy(Right);
+
+				default:
+					break;
+				}
+
+				return Number(int64_t{ 0 });
+			}
+
+			std::string_view Input;
+			std::array<ConstToken, Capacity> Tokens{};
+			std::array<ConstNode, Capacity> Nodes{};
+			size_t TokenCount = 0;
+			size_t NodeCount = 0;
+			size_t TokenIndex = 0;
+		};
+	}
+
+	template <FixedString Source>
+	consteval Number Eval()
+	{
+		return Detail::ConstEvaluator<sizeof(Source.Data)>(Source.View()).Run();
+	}
+}
@@ -0,0 +1,248 @@
+﻿#include "Pch.h"
+
+#include "DirectEvaluator.h"
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+#include "Trace.h"
+
+namespace DirectEvaluator
+{
+	struct PendingOperator
+	{
+		ETokenType Type;
+		bool IsUnary;
+	};
+
+	// Signs bind tighter than any binary operator, brackets are never reduced by precedence
+	static int32_t GetPrecedence(const PendingOperator& Operator)
+	{
+		if (Operator.IsUnary)
+		{
+			return 3;
+		}
+
+		switch (Operator.Type)
+		{
+		case TYPE_MUL:
+		case TYPE_DIV:
+			return 2;
+
+		case TYPE_PLUS:
+		case TYPE_MINUS:
+			return 1;
+
+		default:
+			return 0;
+		}
+	}
+
+	class Evaluator
+	{
+	public:
+		Evaluator(const std::string_view Input, ErrorManager& Errors)
+			: Source(Input, Errors)
+		{
+		}
+
+		bool Run(Number& OutResult)
+		{
+			bool ExpectOperand = true;
+
+			while (true)
+			{
+				const Token CurrentToken = Source.GetNextToken();
+
+				if (ExpectOperand)
+				{
+					switch (CurrentToken.Type)
+					{
+					case TYPE_INT:
+					case TYPE_FLOAT:
+						if (OperandCount == MAX_STACK_DEPTH)
+						{
+							return false;
+						}
+
+						Operands[OperandCount++] = CurrentToken.Literal;
+						ExpectOperand = false;
+						break;
+
+					case TYPE_PLUS:
+					case TYPE_MINUS:
+						if (!PushOperator({ CurrentToken.Type, true }))
+						{
+							return false;
+						}
+
+						break;
+
+					case TYPE_LBRACKET:
+						if (!PushOperator({ TYPE_LBRACKET, false }))
+						{
+							return false;
+						}
+
+						break;
+
+					default:
+						return false;
+					}
+
+					continue;
+				}
+
+				switch (CurrentToken.Type)
+				{
+				case TYPE_PLUS:
+				case TYPE_MINUS:
+				case TYPE_MUL:
+				case TYPE_DIV:
+					{
+						const PendingOperator Operator = { CurrentToken.Type, false };
+
+						// Left associative, reduce everything that binds at least as tight
+						while (OperatorCount > 0 && GetPrecedence(Operators[OperatorCount - 1]) >= GetPrecedence(Operator))
+						{
+							if (!Reduce())
+							{
+								return false;
+							}
+						}
+
+						if (!PushOperator(Operator))
+						{
+							return false;
+						}
+
+						ExpectOperand = true;
+						break;
+					}
+
+				case TYPE_RBRACKET:
+					while (OperatorCount > 0 && Operators[OperatorCount - 1].Type != TYPE_LBRACKET)
+					{
+						if (!Reduce())
+						{
+							return false;
+						}
+					}
+
+					// Unmatched ')'
+					if (OperatorCount == 0)
+					{
+						return false;
+					}
+
+					OperatorCount--;
+					break;
+
+				case TYPE_EOF:
+					// The stream also ends at an illegal character
+					if (Source.HasFailed())
+					{
+						return false;
+					}
+
+					while (OperatorCount > 0)
+					{
+						// Unclosed '(' or division by zero
+						if (Operators[OperatorCount - 1].Type == TYPE_LBRACKET || !Reduce())
+						{
+							return false;
+						}
+					}
+
+					OutResult = Operands[0];
+					return true;
+
+				default:
+					return false;
+				}
+			}
+		}
+
+	private:
+		bool PushOperator(const PendingOperator& Operator)
+		{
+			if (OperatorCount == MAX_STACK_DEPTH)
+			{
+				return false;
+			}
+
+			Operators[OperatorCount++] = Operator;
+			return true;
+		}
+
+		// Applies the top operator, same operations as the Interpreter
+		bool Reduce()
+		{
+			const PendingOperator Operator = Operators[--OperatorCount];
+
+			if (Operator.IsUnary)
+			{
+				Number& Operand = Operands[OperandCount - 1];
+
+				if (Operator.Type == TYPE_MINUS)
+				{
+					Operand = Operand.MultipliedBy(Number(int64_t{ -1 }));
+				}
+
+				return true;
+			}
+
+			const Number Right = Operands[--OperandCount];
+			Number& Left = Operands[OperandCount - 1];
+
+			switch (Operator.Type)
+			{
+			case TYPE_PLUS:
+				Left = Left.AddedTo(Right);
+				return true;
+
+			case TYPE_MINUS:
+				Left = Left.SubtractedBy(Right);
+				return true;
+
+			case TYPE_MUL:
+				Left = Left.MultipliedBy(Right);
+				return true;
+
+			case TYPE_DIV:
+				if ((Right.IsInt && Right.IntValue == 0) || (!Right.IsInt && Right.FloatValue == 0.0))
+				{
+					return false;
+				}
+
+				Left = Left.DividedBy(Right);
+				return true;
+
+			default:
+				return false;
+			}
+		}
+
+		Lexer Source;
+
+		std::array<Number, MAX_STACK_DEPTH> Operands;
+		std::array<PendingOperator, MAX_STACK_DEPTH> Operators{};
+		size_t OperandCount = 0;
+		size_t OperatorCount = 0;
+	};
+
+	[[nodiscard]] bool TryEvaluate(const std::string_view Input, Number& OutResult)
+	{
+		ErrorManager Errors;
+		return TryEvaluate(Input, OutResult, Errors);
+	}
+
+	[[nodiscard]] bool TryEvaluate(const std::string_view Input, Number& OutResult, ErrorManager& Scratch)
+	{
+		WL_TRACE_SCOPE("EvaluateDirect", Input.size());
+
+		// Only needed by the lexer, an illegal character makes the evaluation fail and the full pipeline reports it
+		const bool Succeeded = Evaluator(Input, Scratch).Run(OutResult);
+		Scratch.Clear();
+
+		return Succeeded;
+	}
+}
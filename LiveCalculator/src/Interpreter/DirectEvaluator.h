@@ -0,0 +1,23 @@
+﻿#pragma once
+
+#include "Number.h"
+
+class ErrorManager;
+
+/*
+ * Single pass evaluator for the common case of a well formed expression. Tokens are pulled from the lexer and
+ * reduced on an operand stack and an operator stack of fixed size, no token vector or syntax tree is built.
+ *
+ * TryEvaluate() returns false for anything the full pipeline would report (illegal character, syntax error,
+ * division by 0) and for expressions nesting deeper than the stacks. The caller then runs Lexer, Parser and
+ * Interpreter for the diagnostics. Every input that is accepted gives the same result as the full pipeline.
+ */
+namespace DirectEvaluator
+{
+	inline constexpr size_t MAX_STACK_DEPTH = 64;
+
+	[[nodiscard]] bool TryEvaluate(std::string_view Input, Number& OutResult);
+
+	// Lexer errors go to Scratch and are cleared again, a reused ErrorManager keeps this from allocating
+	[[nodiscard]] bool TryEvaluate(std::string_view Input, Number& OutResult, ErrorManager& Scratch);
+}
@@ -0,0 +1,139 @@
+﻿#include "Pch.h"
+
+#include "EvaluationProfile.h"
+#include "ErrorManager.h"
+
+static const char* GetTypeName(const ENodeType Type)
+{
+	switch (Type)
+	{
+	case NODE_TYPE_NUMBER:
+		return "number";
+
+	case NODE_TYPE_BINARY_OP:
+		return "binary";
+
+	case NODE_TYPE_UNARY_OP:
+		return "unary";
+
+	case NODE_TYPE_ERROR:
+		break;
+	}
+
+	return "error";
+}
+
+static int64_t GetNanoseconds(const std::chrono::steady_clock::duration Time)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Time).count();
+}
+
+[[nodiscard]] std::chrono::steady_clock::duration EvaluationProfile::GetSelfTime(const SyntaxTreeView& Tree, const uint32_t NodeIndex) const
+{
+	const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+	std::chrono::steady_clock::duration Time = Samples[NodeIndex].Time;
+
+	if (Node.Type == NODE_TYPE_BINARY_OP || Node.Type == NODE_TYPE_UNARY_OP)
+	{
+		Time -= Samples[Node.Left].Time;
+	}
+
+	if (Node.Type == NODE_TYPE_BINARY_OP)
+	{
+		Time -= Samples[Node.Right].Time;
+	}
+
+	// The clock is read at slightly different points for parent and child
+	return std::max(Time, std::chrono::steady_clock::duration::zero());
+}
+
+void EvaluationProfile::AppendHeatmap(std::pmr::string& OutText, const SyntaxTreeView& Tree, const uint32_t Root, const std::string_view Text, const size_t MaxEntries) const
+{
+	const NodeSample& RootSample = Samples[Root];
+
+	if (RootSample.VisitCount == 0)
+	{
+		OutText += "Not evaluated\n";
+		return;
+	}
+
+	struct Entry
+	{
+		uint32_t Node;
+		std::chrono::steady_clock::duration SelfTime;
+	};
+
+	std::pmr::vector<Entry> Entries(OutText.get_allocator().resource());
+
+	for (uint32_t Index = Tree.GetFirstNode(Root); Index <= Root; ++Index)
+	{
+		if (Samples[Index].VisitCount != 0)
+		{
+			Entries.push_back({ Index, GetSelfTime(Tree, Index) });
+		}
+	}
+
+	const size_t EntryCount = std::min(MaxEntries, Entries.size());
+
+	std::partial_sort(Entries.begin(), Entries.begin() + static_cast<ptrdiff_t>(EntryCount), Entries.end(), [](const Entry& Left, const Entry& Right)
+	{
+		return Left.SelfTime > Right.SelfTime;
+	});
+
+	const double TotalNanoseconds = static_cast<double>(std::max(GetNanoseconds(RootSample.Time), int64_t{ 1 }));
+
+	std::format_to(std::back_inserter(OutText), "{} nodes visited in {} ns over {} evaluations\n", Entries.size(), GetNanoseconds(RootSample.Time), RootSample.VisitCount);
+
+	for (size_t EntryIndex = 0; EntryIndex < EntryCount; ++EntryIndex)
+	{
+		const Entry& Current = Entries[EntryIndex];
+		const SyntaxNode& Node = Tree.GetNode(Current.Node);
+		const int64_t SelfNanoseconds = GetNanoseconds(Current.SelfTime);
+
+		std::format_to(std::back_inserter(OutText),
+		               "\n{:5.1f}% self {} ns, {} visits, {} {}\n",
+		               100.0 * static_cast<double>(SelfNanoseconds) / TotalNanoseconds,
+		               SelfNanoseconds,
+		               Samples[Current.Node].VisitCount,
+		               GetTypeName(Node.Type),
+		               GTokenTypeNames[Node.Operator]);
+
+		Error::AppendWithArrows(OutText, Text, Node.Start, Node.End);
+		OutText += '\n';
+	}
+}
+
+void EvaluationProfile::AppendJson(std::pmr::string& OutText, const SyntaxTreeView& Tree, const uint32_t Root) const
+{
+	OutText += '[';
+
+	bool IsFirst = true;
+
+	for (uint32_t Index = Tree.GetFirstNode(Root); Index <= Root; ++Index)
+	{
+		const NodeSample& Sample = Samples[Index];
+
+		if (Sample.VisitCount == 0)
+		{
+			continue;
+		}
+
+		const SyntaxNode& Node = Tree.GetNode(Index);
+
+		std::format_to(std::back_inserter(OutText),
+		               "{}\n\t{{ \"node\": {}, \"type\": \"{}\", \"operator\": \"{}\", \"start\": {}, \"end\": {}, \"visits\": {}, \"time_ns\": {}, \"self_ns\": {} }}",
+		               IsFirst ? "" : ",",
+		               Index,
+		               GetTypeName(Node.Type),
+		               GTokenTypeNames[Node.Operator],
+		               Node.Start,
+		               Node.End,
+		               Sample.VisitCount,
+		               GetNanoseconds(Sample.Time),
+		               GetNanoseconds(GetSelfTime(Tree, Index)));
+
+		IsFirst = false;
+	}
+
+	OutText += "\n]\n";
+}
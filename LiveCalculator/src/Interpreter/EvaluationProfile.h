@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+
+#include <chrono>
+
+/*
+ * Visit counts and time per syntax tree node, filled by the profiling overload of Interpreter::Visit. Samples are
+ * indexed like the node pool, so the expressions of a batch parsed into one SyntaxTree share a profile and
+ * evaluating the same tree again adds to the earlier samples:
+ *
+ *		EvaluationProfile Profile;
+ *		Interpreter::Visit(Tree, Root, Errors, Profile);
+ *		Profile.AppendHeatmap(Report, Tree, Root, Input);
+ *
+ * Sampled time includes the children, the reports subtract it again to find the nodes that are slow themselves.
+ */
+class EvaluationProfile
+{
+public:
+	struct NodeSample
+	{
+		uint64_t VisitCount = 0;
+		std::chrono::steady_clock::duration Time{};
+	};
+
+	explicit EvaluationProfile(std::pmr::memory_resource* Resource = std::pmr::get_default_resource())
+		: Samples(Resource)
+	{
+	}
+
+	// Grows the samples to cover a pool of NodeCount nodes, existing samples are kept
+	void Reserve(const size_t NodeCount)
+	{
+		if (Samples.size() < NodeCount)
+		{
+			Samples.resize(NodeCount);
+		}
+	}
+
+	void AddSample(const uint32_t NodeIndex, const std::chrono::steady_clock::duration Time)
+	{
+		NodeSample& Sample = Samples[NodeIndex];
+		Sample.VisitCount++;
+		Sample.Time += Time;
+	}
+
+	[[nodiscard]] const NodeSample& GetSample(const uint32_t NodeIndex) const
+	{
+		return Samples[NodeIndex];
+	}
+
+	// Time of the node minus the time of the children it visited
+	[[nodiscard]] std::chrono::steady_clock::duration GetSelfTime(const SyntaxTreeView& Tree, uint32_t NodeIndex) const;
+
+	// A summary line for each of the MaxEntries nodes of the expression at Root with the most self time,
+	// followed by its source lines with '^' under the node's span. Scratch memory comes from the resource of OutText.
+	void AppendHeatmap(std::pmr::string& OutText, const SyntaxTreeView& Tree, uint32_t Root, std::string_view Text, size_t MaxEntries = 5) const;
+
+	// Every visited node of the expression at Root as a JSON array of
+	// { "node", "type", "operator", "start", "end", "visits", "time_ns", "self_ns" } objects
+	void AppendJson(std::pmr::string& OutText, const SyntaxTreeView& Tree, uint32_t Root) const;
+
+	// Keeps the storage for reuse
+	void Clear()
+	{
+		Samples.clear();
+	}
+
+	// Protected fields and functions
+protected:
+	std::pmr::vector<NodeSample> Samples;
+};
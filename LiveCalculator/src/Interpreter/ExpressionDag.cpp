@@ -0,0 +1,272 @@
+﻿#include "Pch.h"
+
+#include "ExpressionDag.h"
+#include "Interpreter.h"
+#include "ErrorManager.h"
+#include "Trace.h"
+
+#include <cmath>
+
+static uint64_t MixHash(const uint64_t Hash, const uint64_t Value)
+{
+	return (Hash ^ Value) * 0x100000001B3ull + (Hash >> 29);
+}
+
+ExpressionDag::ExpressionDag(std::pmr::memory_resource* Resource)
+	: Nodes(Resource),
+	  Literals(Resource),
+	  Expressions(Resource),
+	  Slots(Resource),
+	  Values(Resource),
+	  Failed(Resource),
+	  NodeMap(Resource)
+{
+}
+
+uint32_t ExpressionDag::AddExpression(const SyntaxTreeView& Tree, const uint32_t Root)
+{
+	WL_TRACE_SCOPE("ShareSubexpressions", Tree.Nodes.size());
+
+	const uint32_t First = Tree.GetFirstNode(Root);
+
+	NodeMap.resize(Root - First + 1);
+
+	// Children come before their parent, so both are already shared when the parent is reached
+	for (uint32_t Index = First; Index <= Root; ++Index)
+	{
+		const SyntaxNode& Node = Tree.GetNode(Index);
+		DagNode Shared = { Node.Type, Node.Operator, 0, 0 };
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_NUMBER:
+			Shared.Left = static_cast<uint32_t>(Literals.size());
+			Literals.push_back(Tree.GetLiteral(Node));
+			break;
+
+		case NODE_TYPE_BINARY_OP:
+			Shared.Left = NodeMap[Node.Left - First];
+			Shared.Right = NodeMap[Node.Right - First];
+			break;
+
+		case NODE_TYPE_UNARY_OP:
+			Shared.Left = NodeMap[Node.Left - First];
+			break;
+
+		case NODE_TYPE_ERROR:
+			Shared.Operator = TYPE_EOF;
+			break;
+		}
+
+		NodeMap[Index - First] = Intern(Shared);
+	}
+
+	Expressions.push_back({ Root, NodeMap.back() });
+	return static_cast<uint32_t>(Expressions.size() - 1);
+}
+
+void ExpressionDag::Evaluate()
+{
+	WL_TRACE_SCOPE("EvaluateShared", Nodes.size());
+
+	const size_t EvaluatedCount = Values.size();
+
+	Values.resize(Nodes.size());
+	Failed.resize(Nodes.size());
+
+	for (size_t Index = EvaluatedCount; Index < Nodes.size(); ++Index)
+	{
+		const DagNode& Node = Nodes[Index];
+		Number& Value = Values[Index];
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_NUMBER:
+			Value = Literals[Node.Left];
+			break;
+
+		case NODE_TYPE_ERROR:
+			Value = Number(int64_t{ 0 });
+			break;
+
+		case NODE_TYPE_UNARY_OP:
+			Value = Node.Operator == TYPE_MINUS ? Values[Node.Left].MultipliedBy(Number(int64_t{ -1 })) : Values[Node.Left];
+			Failed[Index] = Failed[Node.Left];
+			break;
+
+		case NODE_TYPE_BINARY_OP:
+			{
+				// Same recovery as the Interpreter, an operand that failed to parse is skipped
+				if (Nodes[Node.Right].Type == NODE_TYPE_ERROR || Nodes[Node.Left].Type == NODE_TYPE_ERROR)
+				{
+					const uint32_t Present = Nodes[Node.Right].Type == NODE_TYPE_ERROR ? Node.Left : Node.Right;
+					Value = Values[Present];
+					Failed[Index] = Failed[Present];
+					break;
+				}
+
+				Failed[Index] = Failed[Node.Left] || Failed[Node.Right];
+
+				if (Failed[Index])
+				{
+					break;
+				}
+
+				const Number& Left = Values[Node.Left];
+				const Number& Right = Values[Node.Right];
+
+				switch (Node.Operator)
+				{
+				case TYPE_PLUS:
+					Value = Left.AddedTo(Right);
+					break;
+
+				case TYPE_MINUS:
+					Value = Left.SubtractedBy(Right);
+					break;
+
+				case TYPE_MUL:
+					Value = Left.MultipliedBy(Right);
+					break;
+
+				case TYPE_DIV:
+					if ((Right.IsInt && Right.IntValue == 0) || (!Right.IsInt && Right.FloatValue == 0.0))
+					{
+						Failed[Index] = true;
+						break;
+					}
+
+					Value = Left.DividedBy(Right);
+					break;
+
+				default:
+					break;
+				}
+			}
+			break;
+		}
+	}
+}
+
+Number ExpressionDag::GetResult(const SyntaxTreeView& Tree, const uint32_t Expression, ErrorManager& Errors) const
+{
+	const AddedExpression& Added = Expressions[Expression];
+
+	// Only failed expressions are walked again, the error then carries the span of this expression's own node
+	if (Failed[Added.Node])
+	{
+		return Interpreter::Visit(Tree, Added.Root, Errors);
+	}
+
+	return Values[Added.Node];
+}
+
+void ExpressionDag::Clear()
+{
+	Nodes.clear();
+	Literals.clear();
+	Expressions.clear();
+	Values.clear();
+	Failed.clear();
+	std::fill(Slots.begin(), Slots.end(), INVALID_NODE);
+	DeduplicatedCount = 0;
+}
+
+uint32_t ExpressionDag::Intern(const DagNode& Node)
+{
+	if ((Nodes.size() + 1) * 2 > Slots.size())
+	{
+		Grow();
+	}
+
+	const size_t Mask = Slots.size() - 1;
+
+	for (size_t Slot = GetHash(Node) & Mask; ; Slot = (Slot + 1) & Mask)
+	{
+		if (Slots[Slot] == INVALID_NODE)
+		{
+			Slots[Slot] = static_cast<uint32_t>(Nodes.size());
+			Nodes.push_back(Node);
+			return Slots[Slot];
+		}
+
+		if (IsSame(Nodes[Slots[Slot]], Node))
+		{
+			// The literal of a shared number node is not needed twice
+			if (Node.Type == NODE_TYPE_NUMBER)
+			{
+				Literals.pop_back();
+			}
+
+			DeduplicatedCount++;
+			return Slots[Slot];
+		}
+	}
+}
+
+[[nodiscard]] uint64_t ExpressionDag::GetHash(const DagNode& Node) const
+{
+	uint64_t Hash = MixHash(0xCBF29CE484222325ull, static_cast<uint64_t>(Node.Type) << 8 | Node.Operator);
+
+	if (Node.Type == NODE_TYPE_NUMBER)
+	{
+		const Number& Literal = Literals[Node.Left];
+
+		if (Literal.IsInt)
+		{
+			return MixHash(Hash, static_cast<uint64_t>(Literal.IntValue));
+		}
+
+		// Literals are never NaN, -0.0 and 0.0 share a hash and are told apart by IsSame
+		return MixHash(Hash, std::bit_cast<uint64_t>(static_cast<double>(Literal.FloatValue)) & ~(1ull << 63));
+	}
+
+	return MixHash(MixHash(Hash, Node.Left), Node.Right);
+}
+
+[[nodiscard]] bool ExpressionDag::IsSame(const DagNode& First, const DagNode& Second) const
+{
+	if (First.Type != Second.Type || First.Operator != Second.Operator)
+	{
+		return false;
+	}
+
+	if (First.Type == NODE_TYPE_NUMBER)
+	{
+		const Number& FirstLiteral = Literals[First.Left];
+		const Number& SecondLiteral = Literals[Second.Left];
+
+		if (FirstLiteral.IsInt != SecondLiteral.IsInt)
+		{
+			return false;
+		}
+
+		if (FirstLiteral.IsInt)
+		{
+			return FirstLiteral.IntValue == SecondLiteral.IntValue;
+		}
+
+		return FirstLiteral.FloatValue == SecondLiteral.FloatValue && std::signbit(FirstLiteral.FloatValue) == std::signbit(SecondLiteral.FloatValue);
+	}
+
+	return First.Left == Second.Left && First.Right == Second.Right;
+}
+
+void ExpressionDag::Grow()
+{
+	Slots.assign(std::max<size_t>(Slots.size() * 2, 64), INVALID_NODE);
+
+	const size_t Mask = Slots.size() - 1;
+
+	for (uint32_t NodeIndex = 0; NodeIndex < Nodes.size(); ++NodeIndex)
+	{
+		size_t Slot = GetHash(Nodes[NodeIndex]) & Mask;
+
+		while (Slots[Slot] != INVALID_NODE)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+
+		Slots[Slot] = NodeIndex;
+	}
+}
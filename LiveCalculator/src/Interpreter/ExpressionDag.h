@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+#include "Number.h"
+
+class ErrorManager;
+
+/*
+ * Structurally identical subtrees of one or more expressions, shared as a DAG and evaluated once. Nodes are
+ * hash-consed on (type, operator, shared children) and literals on their value, so "(1+2)*3 + (1+2)*4" keeps a
+ * single "1+2" and a batch of generated formulas shares every repeated part between formulas:
+ *
+ *		ExpressionDag Dag;
+ *		const uint32_t First = Dag.AddExpression(Tree, FirstRoot);
+ *		const uint32_t Second = Dag.AddExpression(Tree, SecondRoot);
+ *
+ *		Dag.Evaluate();
+ *		Dag.GetResult(Tree, First, Errors);
+ *
+ * Results are the same as Interpreter::Visit. An expression that divides by zero is walked again with
+ * Interpreter::Visit by GetResult, so its error points at its own source span.
+ */
+class ExpressionDag
+{
+public:
+	explicit ExpressionDag(std::pmr::memory_resource* Resource = std::pmr::get_default_resource());
+
+	// Shares the nodes of the subtree at Root with everything added before, returns the id for GetResult
+	uint32_t AddExpression(const SyntaxTreeView& Tree, uint32_t Root);
+
+	// Evaluates every shared node added since the last call once
+	void Evaluate();
+
+	// Tree has to be the pool the expression was added from, it may have grown since
+	Number GetResult(const SyntaxTreeView& Tree, uint32_t Expression, ErrorManager& Errors) const;
+
+	// Nodes of the added expressions that were replaced by an existing shared node
+	[[nodiscard]] uint64_t GetDeduplicatedCount() const { return DeduplicatedCount; }
+	[[nodiscard]] size_t GetNodeCount() const { return Nodes.size(); }
+
+	// Keeps the storage for reuse
+	void Clear();
+
+	// Protected fields and functions
+protected:
+	// NODE_TYPE_NUMBER keeps the literal index in Left like SyntaxNode, other children are shared node ids
+	struct DagNode
+	{
+		ENodeType Type;
+		ETokenType Operator;
+		uint32_t Left;
+		uint32_t Right;
+	};
+
+	struct AddedExpression
+	{
+		uint32_t Root;
+		uint32_t Node;
+	};
+
+	uint32_t Intern(const DagNode& Node);
+	[[nodiscard]] uint64_t GetHash(const DagNode& Node) const;
+	[[nodiscard]] bool IsSame(const DagNode& First, const DagNode& Second) const;
+	void Grow();
+
+	std::pmr::vector<DagNode> Nodes;
+	std::pmr::vector<Number> Literals;
+	std::pmr::vector<AddedExpression> Expressions;
+
+	// Open addressing over node ids, the size is a power of two and at most half full
+	std::pmr::vector<uint32_t> Slots;
+
+	// Per node, filled by Evaluate()
+	std::pmr::vector<Number> Values;
+	std::pmr::vector<bool> Failed;
+
+	// Shared id of every node of the subtree being added, indexed from its first node
+	std::pmr::vector<uint32_t> NodeMap;
+
+	uint64_t DeduplicatedCount = 0;
+};
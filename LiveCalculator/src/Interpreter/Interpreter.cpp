@@ -1,59 +1,155 @@
 ﻿#include "Pch.h"
 
 #include "Interpreter.h"
+#include "EvaluationProfile.h"
 #include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Trace.h"
 
 namespace Interpreter
 {
-	Number Visit(NodeBase* Root, const bool ClearError)
+	template <bool IsProfiling>
+	static Number VisitNode(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, ESumMode SumMode, SumScratch& Scratch);
+
+	// A '+' or '-' with both operands present, the only nodes a flattened sum walks through
+	static bool IsSumNode(const SyntaxTreeView& Tree, const SyntaxNode& Node)
+	{
+		return Node.Type == NODE_TYPE_BINARY_OP && (Node.Operator == TYPE_PLUS || Node.Operator == TYPE_MINUS)
+		       && Tree.GetNode(Node.Left).Type != NODE_TYPE_ERROR && Tree.GetNode(Node.Right).Type != NODE_TYPE_ERROR;
+	}
+
+	// Operands of the left-deep chain headed by Node
+	static size_t GetSumTermCount(const SyntaxTreeView& Tree, const SyntaxNode& Node)
 	{
-		if (ClearError)
+		size_t TermCount = 2;
+
+		for (const SyntaxNode* Current = &Tree.GetNode(Node.Left); IsSumNode(Tree, *Current); Current = &Tree.GetNode(Current->Left))
 		{
-			ErrorManager::Clear();
+			TermCount++;
 		}
 
-		switch (Root->Type)
+		return TermCount;
+	}
+
+	/*
+	 * The chain headed by Node as one n-ary sum. Operands are still visited left to right so the same error is
+	 * reported first, and the integer/float promotion is kept: integer operands before the first float are added
+	 * as wrapping integers like in the tree, everything from there on is summed in SumMode. Walking the spine in
+	 * a loop also keeps long chains from recursing once per operand.
+	 *
+	 * Terms and values live in Scratch. Chains nested in an operand push theirs above this chain's and truncate
+	 * back to where they started before returning, so one reserved scratch serves the whole tree.
+	 */
+	template <bool IsProfiling>
+	static Number VisitSum(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, const ESumMode SumMode, SumScratch& Scratch)
+	{
+		std::pmr::vector<SumTerm>& Terms = Scratch.Terms;
+		std::pmr::vector<Number::FloatType>& Values = Scratch.Values;
+		const size_t TermBase = Terms.size();
+		const size_t ValueBase = Values.size();
+
+		Terms.push_back({ Node.Right, Node.Operator == TYPE_MINUS });
+
+		uint32_t SpineIndex = Node.Left;
+
+		while (IsSumNode(Tree, Tree.GetNode(SpineIndex)))
 		{
-		case NODE_TYPE_BINARY_OP:
-			return VisitBinaryOperator(dynamic_cast<BinaryOpNode*>(Root));
+			const SyntaxNode& Spine = Tree.GetNode(SpineIndex);
 
-		case NODE_TYPE_NUMBER:
-			return VisitNumberNode(dynamic_cast<NumberNode*>(Root));
+			// Spine nodes are not visited, charge them here
+			if (Budget != nullptr && !Budget->Spend(Errors, Spine.Start, Spine.End))
+			{
+				Terms.resize(TermBase);
+				return Number(int64_t{ 0 });
+			}
 
-		case NODE_TYPE_UNARY_OP:
-			return VisitUnaryOperator(dynamic_cast<UnaryOpNode*>(Root));
+			Terms.push_back({ Spine.Right, Spine.Operator == TYPE_MINUS });
+			SpineIndex = Spine.Left;
 		}
 
-		return Number(0i64);
-	}
+		Terms.push_back({ SpineIndex, false });
+		std::reverse(Terms.begin() + static_cast<ptrdiff_t>(TermBase), Terms.end());
 
-	Number VisitNumberNode(const NumberNode* Node)
-	{
-		if (Node->IsInt)
+		const size_t TermEnd = Terms.size();
+		uint64_t IntSum = 0;
+
+		for (size_t TermIndex = TermBase; TermIndex < TermEnd; ++TermIndex)
+		{
+			// A copy, nested chains may grow Terms
+			const SumTerm Current = Terms[TermIndex];
+			const Number Value = VisitNode<IsProfiling>(Tree, Current.Index, Errors, Budget, Profile, SumMode, Scratch);
+
+			if (Errors.HasErrors())
+			{
+				Terms.resize(TermBase);
+				Values.resize(ValueBase);
+				return Number(int64_t{ 0 });
+			}
+
+			if (Values.size() == ValueBase && Value.IsInt)
+			{
+				IntSum = Current.IsNegative ? IntSum - static_cast<uint64_t>(Value.IntValue) : IntSum + static_cast<uint64_t>(Value.IntValue);
+				continue;
+			}
+
+			// No integer prefix means no 0 to add either, which would turn a -0.0 result into 0.0
+			if (Values.size() == ValueBase && TermIndex != TermBase)
+			{
+				Values.push_back(static_cast<Number::FloatType>(static_cast<int64_t>(IntSum)));
+			}
+
+			const Number::FloatType FloatValue = Value.IsInt ? static_cast<Number::FloatType>(Value.IntValue) : Value.FloatValue;
+			Values.push_back(Current.IsNegative ? -FloatValue : FloatValue);
+		}
+
+		Terms.resize(TermBase);
+
+		if (Values.size() == ValueBase)
 		{
-			return Number(Node->GetIntValue());
+			return Number(static_cast<int64_t>(IntSum));
 		}
 
-		return Number(Node->GetLongDoubleValue());
+		const std::span<const Number::FloatType> Sum(Values.data() + ValueBase, Values.size() - ValueBase);
+		const Number::FloatType Result = SumMode == SUM_MODE_COMPENSATED ? Summation::SumCompensated(Sum) : Summation::SumPairwise(Sum);
+		Values.resize(ValueBase);
+
+		return Number(Result);
 	}
 
-	Number VisitBinaryOperator(const BinaryOpNode* Node)
+	template <bool IsProfiling>
+	static Number VisitBinaryNode(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, const ESumMode SumMode, SumScratch& Scratch)
 	{
-		const Number Left = Visit(Node->LeftNode);
+		// Recovered parse, evaluate the operand that is present so half-typed input still gives a result
+		if (Tree.GetNode(Node.Right).Type == NODE_TYPE_ERROR)
+		{
+			return VisitNode<IsProfiling>(Tree, Node.Left, Errors, Budget, Profile, SumMode, Scratch);
+		}
+
+		if (Tree.GetNode(Node.Left).Type == NODE_TYPE_ERROR)
+		{
+			return VisitNode<IsProfiling>(Tree, Node.Right, Errors, Budget, Profile, SumMode, Scratch);
+		}
 
-		if (!ErrorManager::CheckLastError())
+		if (SumMode != SUM_MODE_STRICT && IsSumNode(Tree, Node) && GetSumTermCount(Tree, Node) >= Summation::MIN_FLAT_TERMS)
 		{
-			return Number(0i64);
+			return VisitSum<IsProfiling>(Tree, Node, Errors, Budget, Profile, SumMode, Scratch);
 		}
 
-		const Number Right = Visit(Node->RightNode);
+		const Number Left = VisitNode<IsProfiling>(Tree, Node.Left, Errors, Budget, Profile, SumMode, Scratch);
 
-		if (!ErrorManager::CheckLastError())
+		if (Errors.HasErrors())
 		{
-			return Number(0i64);
+			return Number(int64_t{ 0 });
 		}
 
-		switch (Node->Token->Type)
+		const Number Right = VisitNode<IsProfiling>(Tree, Node.Right, Errors, Budget, Profile, SumMode, Scratch);
+
+		if (Errors.HasErrors())
+		{
+			return Number(int64_t{ 0 });
+		}
+
+		switch (Node.Operator)
 		{
 		case TYPE_PLUS:
 			return Left.AddedTo(Right);
@@ -65,10 +161,10 @@ namespace Interpreter
 			return Left.MultipliedBy(Right);
 
 		case TYPE_DIV:
-			if (Right.IsInt && Right.IntValue == 0 || !Right.IsInt && Right.LongDoubleValue == 0.0)
+			if ((Right.IsInt && Right.IntValue == 0) || (!Right.IsInt && Right.FloatValue == 0.0))
 			{
-				ErrorManager::SetLastError(Error("Runtime Error", "Integer Division by 0", Node->Start, Node->End));
-				return Number(0i64);
+				Errors.ReportError(ERROR_DIVISION_BY_ZERO, Node.Start, Node.End);
+				return Number(int64_t{ 0 });
 			}
 
 			return Left.DividedBy(Right);
@@ -81,23 +177,114 @@ namespace Interpreter
 			break;
 		}
 
-		return Number(0i64);
+		return Number(int64_t{ 0 });
 	}
 
-	Number VisitUnaryOperator(const UnaryOpNode* Node)
+	template <bool IsProfiling>
+	static Number VisitUnaryNode(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, const ESumMode SumMode, SumScratch& Scratch)
 	{
-		const Number Child = Visit(Node->ChildNode);
+		const Number Child = VisitNode<IsProfiling>(Tree, Node.Left, Errors, Budget, Profile, SumMode, Scratch);
 
-		if (!ErrorManager::CheckLastError())
+		if (Errors.HasErrors())
 		{
-			return Number(0i64);
+			return Number(int64_t{ 0 });
 		}
 
-		if (Node->OperatorToken->Type == TYPE_MINUS)
+		if (Node.Operator == TYPE_MINUS)
 		{
-			return Child.MultipliedBy(Number(-1i64));
+			return Child.MultipliedBy(Number(int64_t{ -1 }));
 		}
 
-		return Number(0i64);
+		return Child;
+	}
+
+	template <bool IsProfiling>
+	static Number DispatchNode(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, const ESumMode SumMode, SumScratch& Scratch)
+	{
+		switch (Node.Type)
+		{
+		case NODE_TYPE_BINARY_OP:
+			return VisitBinaryNode<IsProfiling>(Tree, Node, Errors, Budget, Profile, SumMode, Scratch);
+
+		case NODE_TYPE_NUMBER:
+			return VisitNumberNode(Tree, Node);
+
+		case NODE_TYPE_UNARY_OP:
+			return VisitUnaryNode<IsProfiling>(Tree, Node, Errors, Budget, Profile, SumMode, Scratch);
+
+		case NODE_TYPE_ERROR:
+			break;
+		}
+
+		return Number(int64_t{ 0 });
+	}
+
+	template <bool IsProfiling>
+	static Number VisitNode(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget, EvaluationProfile* Profile, const ESumMode SumMode, SumScratch& Scratch)
+	{
+		const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+
+		if (Budget != nullptr && !Budget->Spend(Errors, Node.Start, Node.End))
+		{
+			return Number(int64_t{ 0 });
+		}
+
+		if constexpr (IsProfiling)
+		{
+			const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+			const Number Result = DispatchNode<true>(Tree, Node, Errors, Budget, Profile, SumMode, Scratch);
+
+			Profile->AddSample(NodeIndex, std::chrono::steady_clock::now() - StartTime);
+			return Result;
+		}
+		else
+		{
+			return DispatchNode<false>(Tree, Node, Errors, Budget, Profile, SumMode, Scratch);
+		}
+	}
+
+	Number Visit(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget)
+	{
+		return Visit(Tree, NodeIndex, Errors, SUM_MODE_STRICT, Budget);
+	}
+
+	Number Visit(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, const ESumMode SumMode, EvaluationBudget* Budget)
+	{
+		SumScratch Scratch;
+		return Visit(Tree, NodeIndex, Errors, SumMode, Scratch, Budget);
+	}
+
+	Number Visit(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, const ESumMode SumMode, SumScratch& Scratch, EvaluationBudget* Budget)
+	{
+		WL_TRACE_SCOPE("Interpret", Tree.Nodes.size());
+		return VisitNode<false>(Tree, NodeIndex, Errors, Budget, nullptr, SumMode, Scratch);
+	}
+
+	Number Visit(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, EvaluationProfile& Profile, EvaluationBudget* Budget)
+	{
+		WL_TRACE_SCOPE("InterpretProfiled", Tree.Nodes.size());
+
+		// Strict sums never touch the scratch, it stays empty and does not allocate
+		SumScratch Scratch;
+
+		Profile.Reserve(Tree.Nodes.size());
+		return VisitNode<true>(Tree, NodeIndex, Errors, Budget, &Profile, SUM_MODE_STRICT, Scratch);
+	}
+
+	Number VisitNumberNode(const SyntaxTreeView& Tree, const SyntaxNode& Node)
+	{
+		return Tree.GetLiteral(Node);
+	}
+
+	Number VisitBinaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget)
+	{
+		SumScratch Scratch;
+		return VisitBinaryNode<false>(Tree, Node, Errors, Budget, nullptr, SUM_MODE_STRICT, Scratch);
+	}
+
+	Number VisitUnaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget)
+	{
+		SumScratch Scratch;
+		return VisitUnaryNode<false>(Tree, Node, Errors, Budget, nullptr, SUM_MODE_STRICT, Scratch);
 	}
 }
@@ -2,11 +2,54 @@
 
 #include "../Parser/NodeTypes.h"
 #include "Number.h"
+#include "Summation.h"
+
+class ErrorManager;
+class EvaluationBudget;
+class EvaluationProfile;
 
 namespace Interpreter
 {
-	Number Visit(NodeBase* Root, bool ClearError = false);
-	Number VisitNumberNode(const NumberNode* Node);
-	Number VisitBinaryOperator(const BinaryOpNode* Node);
-	Number VisitUnaryOperator(const UnaryOpNode* Node);
+	struct SumTerm
+	{
+		uint32_t Index;
+		bool IsNegative;
+	};
+
+	// Operands of the flattened sums, nested chains stack theirs above the enclosing one. A tree of up to the
+	// reserved node count is summed without allocating.
+	struct SumScratch
+	{
+		explicit SumScratch(std::pmr::memory_resource* Resource = std::pmr::get_default_resource())
+			: Terms(Resource),
+			  Values(Resource)
+		{
+		}
+
+		void Reserve(const size_t NodeCount)
+		{
+			Terms.reserve(NodeCount);
+			Values.reserve(NodeCount);
+		}
+
+		std::pmr::vector<SumTerm> Terms;
+		std::pmr::vector<Number::FloatType> Values;
+	};
+
+	// Every visited node is charged to Budget when one is given
+	Number Visit(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+
+	// Same, except that '+'/'-' chains of at least Summation::MIN_FLAT_TERMS operands are added as one flattened sum
+	// in SumMode. Integer results do not change, floating-point results can differ in the last digits.
+	Number Visit(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, ESumMode SumMode, EvaluationBudget* Budget = nullptr);
+
+	// Same, with the sums' storage kept by the caller between evaluations
+	Number Visit(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, ESumMode SumMode, SumScratch& Scratch, EvaluationBudget* Budget = nullptr);
+	Number VisitNumberNode(const SyntaxTreeView& Tree, const SyntaxNode& Node);
+	Number VisitBinaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+	Number VisitUnaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+
+	// Same result, also adds a visit and the time spent to Profile for every node. The walk above is a separate
+	// instantiation without the clock reads, so profiling costs nothing unless this overload is called.
+	Number Visit(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, EvaluationProfile& Profile, EvaluationBudget* Budget = nullptr);
 }
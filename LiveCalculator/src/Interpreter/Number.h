@@ -1,18 +1,144 @@
 ﻿#pragma once
 
-class Number
+#include "NumberPolicy.h"
+
+#include <cmath>
+
+// Number is fully constexpr so the compile-time evaluator (ConstEvaluator.h) shares the same promotion rules.
+// TPolicy picks the floating-point type, the rest of the engine uses the Number alias of the policy it was built for.
+//
+// Integer +, - and * are done on uint64_t and wrap around in two's complement. Overflowing a signed int64_t is
+// undefined behaviour, "9223372036854775807+1" is all it takes, so UBSan and the fuzz targets in Fuzz/ report it and
+// the optimizer may assume it never happens. Wrapping is also what keeps ParallelInterpreter exact: it regroups
+// integer chains, and (a+b)+c equals a+(b+c) for every input only when an overflow wraps the same way in any order.
+template <typename TPolicy>
+class BasicNumber
 {
 	// Access functions
 public:
-	explicit Number(int64_t Value);
-	explicit Number(long double Value);
+	using FloatType = typename TPolicy::FloatType;
+
+	// Integer zero
+	constexpr BasicNumber()
+		: IsInt(true), IntValue(0), FloatValue(0)
+	{
+	}
+
+	constexpr explicit BasicNumber(const int64_t Value)
+		: IsInt(true), IntValue(Value), FloatValue(0)
+	{
+	}
+
+	constexpr explicit BasicNumber(const FloatType Value)
+		: IsInt(false), IntValue(0), FloatValue(Value)
+	{
+	}
+
+	[[nodiscard]] constexpr BasicNumber AddedTo(const BasicNumber& Other) const
+	{
+		if (IsInt && Other.IsInt)
+		{
+			return BasicNumber(static_cast<int64_t>(static_cast<uint64_t>(IntValue) + static_cast<uint64_t>(Other.IntValue)));
+		}
+
+		if (IsInt && !Other.IsInt)
+		{
+			return BasicNumber(static_cast<FloatType>(IntValue) + Other.FloatValue);
+		}
+
+		if (!IsInt && Other.IsInt)
+		{
+			return BasicNumber(FloatValue + static_cast<FloatType>(Other.IntValue));
+		}
+
+		return BasicNumber(FloatValue + Other.FloatValue);
+	}
+
+	[[nodiscard]] constexpr BasicNumber SubtractedBy(const BasicNumber& Other) const
+	{
+		if (IsInt && Other.IsInt)
+		{
+			return BasicNumber(static_cast<int64_t>(static_cast<uint64_t>(IntValue) - static_cast<uint64_t>(Other.IntValue)));
+		}
+
+		if (IsInt && !Other.IsInt)
+		{
+			return BasicNumber(static_cast<FloatType>(IntValue) - Other.FloatValue);
+		}
+
+		if (!IsInt && Other.IsInt)
+		{
+			return BasicNumber(FloatValue - static_cast<FloatType>(Other.IntValue));
+		}
+
+		return BasicNumber(FloatValue - Other.FloatValue);
+	}
 
-	[[nodiscard]] Number AddedTo(const Number& Other) const;
-	[[nodiscard]] Number SubtractedBy(const Number& Other) const;
-	[[nodiscard]] Number MultipliedBy(const Number& Other) const;
-	[[nodiscard]] Number DividedBy(const Number& Other) const;
+	[[nodiscard]] constexpr BasicNumber MultipliedBy(const BasicNumber& Other) const
+	{
+		if (IsInt && Other.IsInt)
+		{
+			return BasicNumber(static_cast<int64_t>(static_cast<uint64_t>(IntValue) * static_cast<uint64_t>(Other.IntValue)));
+		}
+
+		if (IsInt && !Other.IsInt)
+		{
+			return BasicNumber(static_cast<FloatType>(IntValue) * Other.FloatValue);
+		}
+
+		if (!IsInt && Other.IsInt)
+		{
+			return BasicNumber(FloatValue * static_cast<FloatType>(Other.IntValue));
+		}
+
+		return BasicNumber(FloatValue * Other.FloatValue);
+	}
+
+	[[nodiscard]] constexpr BasicNumber DividedBy(const BasicNumber& Other) const
+	{
+		if (IsInt && Other.IsInt)
+		{
+			return BasicNumber(static_cast<FloatType>(IntValue) / static_cast<FloatType>(Other.IntValue));
+		}
+
+		if (IsInt && !Other.IsInt)
+		{
+			return BasicNumber(static_cast<FloatType>(IntValue) / Other.FloatValue);
+		}
+
+		if (!IsInt && Other.IsInt)
+		{
+			return BasicNumber(FloatValue / static_cast<FloatType>(Other.IntValue));
+		}
+
+		return BasicNumber(FloatValue / Other.FloatValue);
+	}
+
+	// Same type and same value, every NaN equals every other NaN and 0.0 differs from -0.0. Tests and fuzz targets
+	// compare backends with it.
+	[[nodiscard]] bool IsIdenticalTo(const BasicNumber& Other) const
+	{
+		if (IsInt != Other.IsInt)
+		{
+			return false;
+		}
+
+		if (IsInt)
+		{
+			return IntValue == Other.IntValue;
+		}
+
+		if (std::isnan(FloatValue) || std::isnan(Other.FloatValue))
+		{
+			return std::isnan(FloatValue) && std::isnan(Other.FloatValue);
+		}
+
+		return FloatValue == Other.FloatValue && std::signbit(FloatValue) == std::signbit(Other.FloatValue);
+	}
 
 	bool IsInt;
 	int64_t IntValue;
-	long double LongDoubleValue;
+	FloatType FloatValue;
 };
+
+using Number = BasicNumber<NumberPolicy>;
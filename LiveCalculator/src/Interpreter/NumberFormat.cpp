@@ -0,0 +1,100 @@
+﻿#include "Pch.h"
+
+#include "NumberFormat.h"
+
+#include <cmath>
+
+namespace NumberFormat
+{
+	static char* WriteHexPrefix(char* First, char* Last, const bool IsNegative)
+	{
+		const std::string_view Prefix = IsNegative ? "-0x" : "0x";
+
+		if (Last - First < static_cast<ptrdiff_t>(Prefix.size()))
+		{
+			return nullptr;
+		}
+
+		return std::copy(Prefix.begin(), Prefix.end(), First);
+	}
+
+	static char* FormatInt(char* First, char* Last, const int64_t Value, const FormatOptions& Options)
+	{
+		if (Options.Notation != NOTATION_HEX)
+		{
+			const std::to_chars_result Result = std::to_chars(First, Last, Value);
+			return Result.ec == std::errc() ? Result.ptr : nullptr;
+		}
+
+		First = WriteHexPrefix(First, Last, Value < 0);
+
+		if (First == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Through uint64_t so INT64_MIN has an absolute value
+		const uint64_t Absolute = Value < 0 ? 0 - static_cast<uint64_t>(Value) : static_cast<uint64_t>(Value);
+		const std::to_chars_result Result = std::to_chars(First, Last, Absolute, 16);
+
+		return Result.ec == std::errc() ? Result.ptr : nullptr;
+	}
+
+	static char* FormatFloat(char* First, char* Last, Number::FloatType Value, const FormatOptions& Options)
+	{
+		std::chars_format Format;
+
+		switch (Options.Notation)
+		{
+		case NOTATION_FIXED:
+			Format = std::chars_format::fixed;
+			break;
+
+		case NOTATION_SCIENTIFIC:
+			Format = std::chars_format::scientific;
+			break;
+
+		case NOTATION_GENERAL:
+			Format = std::chars_format::general;
+			break;
+
+		case NOTATION_HEX:
+			Format = std::chars_format::hex;
+
+			if (!std::isfinite(Value))
+			{
+				break;
+			}
+
+			First = WriteHexPrefix(First, Last, std::signbit(Value));
+			Value = std::abs(Value);
+
+			if (First == nullptr)
+			{
+				return nullptr;
+			}
+
+			break;
+
+		default:
+			{
+				// Plain shortest round-trip
+				const std::to_chars_result Result = std::to_chars(First, Last, Value);
+				return Result.ec == std::errc() ? Result.ptr : nullptr;
+			}
+		}
+
+		const std::to_chars_result Result = Options.Precision < 0 ? std::to_chars(First, Last, Value, Format) : std::to_chars(First, Last, Value, Format, Options.Precision);
+		return Result.ec == std::errc() ? Result.ptr : nullptr;
+	}
+
+	[[nodiscard]] char* Format(char* First, char* Last, const Number& Value, const FormatOptions& Options)
+	{
+		if (Value.IsInt)
+		{
+			return FormatInt(First, Last, Value.IntValue, Options);
+		}
+
+		return FormatFloat(First, Last, Value.FloatValue, Options);
+	}
+}
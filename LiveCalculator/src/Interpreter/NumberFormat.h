@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "Number.h"
+
+enum ENotation : uint8_t
+{
+	NOTATION_SHORTEST,   // Shortest text that parses back to the same value, same as std::format("{}")
+	NOTATION_FIXED,      // 123.456
+	NOTATION_SCIENTIFIC, // 1.23456e+02
+	NOTATION_GENERAL,    // Fixed or scientific, whichever is shorter, like printf %g
+	NOTATION_HEX         // 0x7b for integers, 0x1.edd2f1a9fbe77p+6 for floats
+};
+
+struct FormatOptions
+{
+	ENotation Notation = NOTATION_SHORTEST;
+
+	// Digits after the point (significant digits for NOTATION_GENERAL), -1 for the shortest round-trip text.
+	// Integers ignore it.
+	int32_t Precision = -1;
+};
+
+/*
+ * Result formatting into caller provided buffers with std::to_chars, correctly rounded and locale independent.
+ * Nothing is allocated, so the same buffer can be reused for any number of results.
+ */
+namespace NumberFormat
+{
+	// Enough for every notation except NOTATION_FIXED, which needs one character per digit of the integer part
+	// (up to 4933 for an 80-bit long double) plus the precision.
+	inline constexpr size_t MAX_LENGTH = 128;
+
+	// Writes Value to [First, Last) without a terminating null. Returns the end of the text, or nullptr when it does not fit.
+	[[nodiscard]] char* Format(char* First, char* Last, const Number& Value, const FormatOptions& Options = {});
+}
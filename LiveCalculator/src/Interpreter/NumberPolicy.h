@@ -0,0 +1,65 @@
+﻿#pragma once
+
+/*
+ * Floating-point types for BasicNumber. Integers are always int64_t, a policy only picks the type that literals
+ * with a fraction or an exponent and every division promote to. The engine is built for one policy, chosen with
+ * "premake5 --number=<policy> <action>":
+ *
+ *		longdouble	80-bit x87 with GCC and Clang on x86-64, the same as double with MSVC (default)
+ *		double		SSE2, vectorizes and is the only one the JIT compiles for
+ *		float		About 7 significant digits, for deployments that only need a rough result
+ */
+struct LongDoublePolicy
+{
+	using FloatType = long double;
+
+	static constexpr const char* NAME = "long double";
+
+	// Recorded by files that store Numbers, see ExpressionCache
+	static constexpr uint8_t ID = 0;
+
+	// Suffix of a C++ literal of FloatType, used by the kernel generator
+	static constexpr const char* LITERAL_SUFFIX = "L";
+
+	// Like strtold, picks infinity or zero for literals std::from_chars reports out of range
+	static FloatType Parse(const char* Text)
+	{
+		return std::strtold(Text, nullptr);
+	}
+};
+
+struct DoublePolicy
+{
+	using FloatType = double;
+
+	static constexpr const char* NAME = "double";
+	static constexpr uint8_t ID = 1;
+	static constexpr const char* LITERAL_SUFFIX = "";
+
+	static FloatType Parse(const char* Text)
+	{
+		return std::strtod(Text, nullptr);
+	}
+};
+
+struct FloatPolicy
+{
+	using FloatType = float;
+
+	static constexpr const char* NAME = "float";
+	static constexpr uint8_t ID = 2;
+	static constexpr const char* LITERAL_SUFFIX = "f";
+
+	static FloatType Parse(const char* Text)
+	{
+		return std::strtof(Text, nullptr);
+	}
+};
+
+#if defined(WL_NUMBER_DOUBLE)
+using NumberPolicy = DoublePolicy;
+#elif defined(WL_NUMBER_FLOAT)
+using NumberPolicy = FloatPolicy;
+#else
+using NumberPolicy = LongDoublePolicy;
+#endif
@@ -0,0 +1,411 @@
+﻿#include "Pch.h"
+
+#include "ParallelInterpreter.h"
+#include "Interpreter.h"
+#include "ErrorManager.h"
+#include "Trace.h"
+
+namespace ParallelInterpreter
+{
+	enum ENodeRole : uint8_t
+	{
+		ROLE_NORMAL,
+		ROLE_CHAIN_HEAD,  // Topmost node of a reassociated chain, combines all operands of the chain
+		ROLE_CHAIN_MEMBER // Inner node of a chain, not evaluated on its own
+	};
+
+	// Range of the node pool evaluated by one worker, only nodes outside the spine are evaluated
+	struct Chunk
+	{
+		uint32_t Begin;
+		uint32_t End;
+		uint32_t FirstError = INVALID_NODE;
+	};
+
+	class Evaluation
+	{
+	public:
+		Evaluation(const SyntaxTree& Tree, const uint32_t Root, const ParallelOptions& Options)
+			: Tree(Tree),
+			  Options(Options),
+			  Root(Root),
+			  Begin(SyntaxTreeView(Tree).GetFirstNode(Root))
+		{
+		}
+
+		[[nodiscard]] uint32_t GetNodeCount() const
+		{
+			return Root - Begin + 1;
+		}
+
+		Number Run(ErrorManager& Errors)
+		{
+			Prepare();
+
+			std::vector<Chunk> Chunks = GetChunks();
+			std::atomic<size_t> NextChunk = 0;
+
+			const auto Worker = [&]()
+			{
+				for (size_t ChunkIndex = NextChunk++; ChunkIndex < Chunks.size(); ChunkIndex = NextChunk++)
+				{
+					EvaluateChunk(Chunks[ChunkIndex]);
+				}
+			};
+
+			uint32_t ThreadCount = Options.ThreadCount != 0 ? Options.ThreadCount : std::thread::hardware_concurrency();
+			ThreadCount = std::clamp(ThreadCount, 1u, static_cast<uint32_t>(std::max<size_t>(Chunks.size(), 1)));
+
+			std::vector<std::thread> Threads;
+
+			for (uint32_t ThreadIndex = 1; ThreadIndex < ThreadCount; ++ThreadIndex)
+			{
+				Threads.emplace_back(Worker);
+			}
+
+			Worker();
+
+			for (std::thread& Thread : Threads)
+			{
+				Thread.join();
+			}
+
+			uint32_t FirstError = INVALID_NODE;
+
+			for (const Chunk& CurrentChunk : Chunks)
+			{
+				FirstError = std::min(FirstError, CurrentChunk.FirstError);
+			}
+
+			// Spine nodes depend on chunks and on earlier spine nodes only
+			for (uint32_t Index = Begin; Index <= Root && Index < FirstError; ++Index)
+			{
+				if (IsSpine(Index) && !EvaluateNode(Index))
+				{
+					FirstError = Index;
+				}
+			}
+
+			if (FirstError != INVALID_NODE)
+			{
+				const SyntaxNode& Node = Tree.GetNode(FirstError);
+				Errors.ReportError(ERROR_DIVISION_BY_ZERO, Node.Start, Node.End);
+				return Number(int64_t{ 0 });
+			}
+
+			return Values[Root - Begin];
+		}
+
+	private:
+		// Per node data in one sweep, children come before their parent
+		void Prepare()
+		{
+			const uint32_t NodeCount = GetNodeCount();
+
+			First.resize(NodeCount);
+			Parent.assign(NodeCount, INVALID_NODE);
+			IsInt.resize(NodeCount);
+			Roles.assign(NodeCount, ROLE_NORMAL);
+			Values.resize(NodeCount);
+
+			for (uint32_t Index = Begin; Index <= Root; ++Index)
+			{
+				const SyntaxNode& Node = Tree.GetNode(Index);
+				const uint32_t Local = Index - Begin;
+
+				switch (Node.Type)
+				{
+				case NODE_TYPE_NUMBER:
+					First[Local] = Index;
+					IsInt[Local] = Node.Operator == TYPE_INT;
+					break;
+
+				case NODE_TYPE_ERROR:
+					First[Local] = Index;
+					IsInt[Local] = true;
+					break;
+
+				case NODE_TYPE_UNARY_OP:
+					First[Local] = First[Node.Left - Begin];
+					Parent[Node.Left - Begin] = Index;
+					IsInt[Local] = IsInt[Node.Left - Begin];
+					break;
+
+				case NODE_TYPE_BINARY_OP:
+					First[Local] = First[Node.Left - Begin];
+					Parent[Node.Left - Begin] = Index;
+					Parent[Node.Right - Begin] = Index;
+
+					if (IsErrorNode(Node.Right))
+					{
+						IsInt[Local] = IsInt[Node.Left - Begin];
+					}
+					else if (IsErrorNode(Node.Left))
+					{
+						IsInt[Local] = IsInt[Node.Right - Begin];
+					}
+					else
+					{
+						IsInt[Local] = Node.Operator != TYPE_DIV && IsInt[Node.Left - Begin] && IsInt[Node.Right - Begin];
+					}
+
+					break;
+				}
+			}
+
+			// Children are visited first, so their roles are final when the parent decides whether it heads a chain
+			for (uint32_t Index = Begin; Index <= Root; ++Index)
+			{
+				if (!CanReassociate(Index))
+				{
+					continue;
+				}
+
+				const SyntaxNode& Node = Tree.GetNode(Index);
+				const uint32_t ParentIndex = Parent[Index - Begin];
+
+				if (ParentIndex != INVALID_NODE && CanReassociate(ParentIndex) && Tree.GetNode(ParentIndex).Operator == Node.Operator
+				    && IsInt[ParentIndex - Begin] == IsInt[Index - Begin])
+				{
+					Roles[Index - Begin] = ROLE_CHAIN_MEMBER;
+				}
+				else if (Roles[Node.Left - Begin] == ROLE_CHAIN_MEMBER || Roles[Node.Right - Begin] == ROLE_CHAIN_MEMBER)
+				{
+					// Two operands are combined the same way in either order, only longer chains need a head
+					Roles[Index - Begin] = ROLE_CHAIN_HEAD;
+				}
+			}
+		}
+
+		[[nodiscard]] bool IsErrorNode(const uint32_t Index) const
+		{
+			return Tree.GetNode(Index).Type == NODE_TYPE_ERROR;
+		}
+
+		[[nodiscard]] bool CanReassociate(const uint32_t Index) const
+		{
+			const SyntaxNode& Node = Tree.GetNode(Index);
+
+			if (Node.Type != NODE_TYPE_BINARY_OP || (Node.Operator != TYPE_PLUS && Node.Operator != TYPE_MUL))
+			{
+				return false;
+			}
+
+			if (IsErrorNode(Node.Left) || IsErrorNode(Node.Right))
+			{
+				return false;
+			}
+
+			return IsInt[Index - Begin] ? Options.ReassociateIntegers : Options.ReassociateFloats;
+		}
+
+		[[nodiscard]] bool IsSpine(const uint32_t Index) const
+		{
+			return Index - First[Index - Begin] + 1 >= Options.SequentialThreshold;
+		}
+
+		// Groups the small subtrees hanging off the spine into chunks of at least SequentialThreshold nodes
+		[[nodiscard]] std::vector<Chunk> GetChunks() const
+		{
+			std::vector<Chunk> Chunks;
+			uint32_t ChunkBegin = Begin;
+			uint32_t ChunkNodeCount = 0;
+
+			for (uint32_t Index = Begin; Index <= Root; ++Index)
+			{
+				if (IsSpine(Index))
+				{
+					continue;
+				}
+
+				ChunkNodeCount++;
+
+				// A chunk may only end after the root of a small subtree, never inside one
+				const uint32_t ParentIndex = Parent[Index - Begin];
+				const bool IsSubtreeRoot = ParentIndex == INVALID_NODE || IsSpine(ParentIndex);
+
+				if (IsSubtreeRoot && ChunkNodeCount >= Options.SequentialThreshold)
+				{
+					Chunks.push_back({ ChunkBegin, Index });
+					ChunkBegin = Index + 1;
+					ChunkNodeCount = 0;
+				}
+			}
+
+			if (ChunkNodeCount > 0)
+			{
+				Chunks.push_back({ ChunkBegin, Root });
+			}
+
+			return Chunks;
+		}
+
+		void EvaluateChunk(Chunk& CurrentChunk)
+		{
+			for (uint32_t Index = CurrentChunk.Begin; Index <= CurrentChunk.End; ++Index)
+			{
+				if (!IsSpine(Index) && !EvaluateNode(Index))
+				{
+					CurrentChunk.FirstError = Index;
+					return;
+				}
+			}
+		}
+
+		// Returns false on division by zero
+		bool EvaluateNode(const uint32_t Index)
+		{
+			const SyntaxNode& Node = Tree.GetNode(Index);
+			Number& Value = Values[Index - Begin];
+
+			switch (Node.Type)
+			{
+			case NODE_TYPE_NUMBER:
+				Value = Tree.GetLiteral(Node);
+				return true;
+
+			case NODE_TYPE_ERROR:
+				return true;
+
+			case NODE_TYPE_UNARY_OP:
+				Value = Values[Node.Left - Begin];
+
+				if (Node.Operator == TYPE_MINUS)
+				{
+					Value = Value.MultipliedBy(Number(int64_t{ -1 }));
+				}
+
+				return true;
+
+			case NODE_TYPE_BINARY_OP:
+				break;
+			}
+
+			// Recovered parse, the operand that is present is the value
+			if (IsErrorNode(Node.Right))
+			{
+				Value = Values[Node.Left - Begin];
+				return true;
+			}
+
+			if (IsErrorNode(Node.Left))
+			{
+				Value = Values[Node.Right - Begin];
+				return true;
+			}
+
+			if (Roles[Index - Begin] == ROLE_CHAIN_MEMBER)
+			{
+				return true;
+			}
+
+			if (Roles[Index - Begin] == ROLE_CHAIN_HEAD)
+			{
+				Value = CombineChain(Index);
+				return true;
+			}
+
+			const Number& Left = Values[Node.Left - Begin];
+			const Number& Right = Values[Node.Right - Begin];
+
+			switch (Node.Operator)
+			{
+			case TYPE_PLUS:
+				Value = Left.AddedTo(Right);
+				return true;
+
+			case TYPE_MINUS:
+				Value = Left.SubtractedBy(Right);
+				return true;
+
+			case TYPE_MUL:
+				Value = Left.MultipliedBy(Right);
+				return true;
+
+			case TYPE_DIV:
+				if ((Right.IsInt && Right.IntValue == 0) || (!Right.IsInt && Right.FloatValue == 0.0))
+				{
+					return false;
+				}
+
+				Value = Left.DividedBy(Right);
+				return true;
+
+			default:
+				return true;
+			}
+		}
+
+		// Collects the operands of a chain left to right and combines neighbours until one value is left
+		[[nodiscard]] Number CombineChain(const uint32_t Head) const
+		{
+			const ETokenType Operator = Tree.GetNode(Head).Operator;
+
+			std::vector<Number> Operands;
+			std::vector<uint32_t> Pending = { Head };
+
+			while (!Pending.empty())
+			{
+				const uint32_t Index = Pending.back();
+				Pending.pop_back();
+
+				if (Index == Head || Roles[Index - Begin] == ROLE_CHAIN_MEMBER)
+				{
+					Pending.push_back(Tree.GetNode(Index).Right);
+					Pending.push_back(Tree.GetNode(Index).Left);
+				}
+				else
+				{
+					Operands.push_back(Values[Index - Begin]);
+				}
+			}
+
+			while (Operands.size() > 1)
+			{
+				size_t Count = 0;
+
+				for (size_t Index = 0; Index + 1 < Operands.size(); Index += 2)
+				{
+					Operands[Count++] = Operator == TYPE_PLUS ? Operands[Index].AddedTo(Operands[Index + 1]) : Operands[Index].MultipliedBy(Operands[Index + 1]);
+				}
+
+				if (Operands.size() % 2 == 1)
+				{
+					Operands[Count++] = Operands.back();
+				}
+
+				Operands.resize(Count);
+			}
+
+			return Operands.front();
+		}
+
+		const SyntaxTree& Tree;
+		const ParallelOptions& Options;
+		const uint32_t Root;
+		const uint32_t Begin;
+
+		// Indexed by node index - Begin
+		std::vector<uint32_t> First;
+		std::vector<uint32_t> Parent;
+		std::vector<bool> IsInt;
+		std::vector<ENodeRole> Roles;
+		std::vector<Number> Values;
+	};
+
+	Number Visit(const SyntaxTree& Tree, const uint32_t Root, ErrorManager& Errors, const ParallelOptions& Options)
+	{
+		// Worker threads are not traced, they only live for one call
+		WL_TRACE_SCOPE("InterpretParallel", Tree.Nodes.size());
+
+		Evaluation CurrentEvaluation(Tree, Root, Options);
+
+		// Interpreter::Visit stops at errors that were reported before, small trees are not worth the threads
+		if (Errors.HasErrors() || CurrentEvaluation.GetNodeCount() < Options.SequentialThreshold)
+		{
+			return Interpreter::Visit(Tree, Root, Errors);
+		}
+
+		return CurrentEvaluation.Run(Errors);
+	}
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+#include "Number.h"
+
+class ErrorManager;
+
+struct ParallelOptions
+{
+	// Subtrees with fewer nodes are evaluated by a single thread, expressions below this use Interpreter::Visit
+	uint32_t SequentialThreshold = 16384;
+
+	// 0 uses std::thread::hardware_concurrency()
+	uint32_t ThreadCount = 0;
+
+	// Combine chains of '+' or '*' as balanced trees instead of left to right.
+	// Integer chains give the same result either way, floating-point chains can round differently.
+	bool ReassociateIntegers = true;
+	bool ReassociateFloats = false;
+};
+
+/*
+ * Evaluator for very large trees. Children are always stored before their parent and every subtree occupies a
+ * contiguous range of the node pool, so the tree is evaluated by sweeping that range instead of recursing:
+ *
+ *		- nodes whose subtree has at least SequentialThreshold nodes form the spine
+ *		- every other node belongs to one small subtree hanging off the spine, these are grouped into chunks
+ *		  that worker threads take from a shared counter
+ *		- the spine is swept last on the calling thread
+ *
+ * The result, including int/float promotion, is the same as Interpreter::Visit. When several divisions by zero
+ * are present the one Interpreter::Visit would reach first (the lowest node index) is reported.
+ */
+namespace ParallelInterpreter
+{
+	Number Visit(const SyntaxTree& Tree, uint32_t Root, ErrorManager& Errors, const ParallelOptions& Options = {});
+}
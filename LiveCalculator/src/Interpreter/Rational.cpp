@@ -0,0 +1,376 @@
+﻿#include "Pch.h"
+
+#include "Rational.h"
+
+#include <cmath>
+
+// Overflow checked helpers for the small path, a result of INT64_MIN counts as overflow
+static bool CheckedAdd(const int64_t Left, const int64_t Right, int64_t& OutResult)
+{
+	if (Right > 0 ? Left > INT64_MAX - Right : Left <= INT64_MIN - Right)
+	{
+		return false;
+	}
+
+	OutResult = Left + Right;
+	return true;
+}
+
+static bool CheckedMultiply(const int64_t Left, const int64_t Right, int64_t& OutResult)
+{
+	if (Left == 0 || Right == 0)
+	{
+		OutResult = 0;
+		return true;
+	}
+
+	// Neither operand is INT64_MIN, so both absolute values fit
+	if (std::abs(Left) > INT64_MAX / std::abs(Right))
+	{
+		return false;
+	}
+
+	OutResult = Left * Right;
+	return true;
+}
+
+Rational::Rational(const int64_t Value)
+	: Numerator(Value), Denominator(1)
+{
+	if (Value == INT64_MIN)
+	{
+		Big = std::make_shared<const BigFraction>(BigFraction{ BigInt(Value), BigInt(int64_t{ 1 }) });
+	}
+}
+
+Rational::Rational(const BigInt& InNumerator, const BigInt& InDenominator)
+	: Numerator(0), Denominator(1)
+{
+	const BigInt Divisor = BigInt::Gcd(InNumerator, InDenominator);
+
+	BigInt ReducedNumerator = InNumerator.DividedBy(Divisor);
+	BigInt ReducedDenominator = InDenominator.DividedBy(Divisor);
+
+	if (ReducedDenominator.IsNegative())
+	{
+		ReducedNumerator = ReducedNumerator.Negated();
+		ReducedDenominator = ReducedDenominator.Negated();
+	}
+
+	const auto FitsSmall = [](const BigInt& Value)
+	{
+		return Value.FitsInt64() && Value.ToInt64() != INT64_MIN;
+	};
+
+	if (FitsSmall(ReducedNumerator) && FitsSmall(ReducedDenominator))
+	{
+		Numerator = ReducedNumerator.ToInt64();
+		Denominator = ReducedDenominator.ToInt64();
+	}
+	else
+	{
+		Big = std::make_shared<const BigFraction>(BigFraction{ std::move(ReducedNumerator), std::move(ReducedDenominator) });
+	}
+}
+
+// Shortest round-trip text in the precision of T, a float widened to long double would print all its binary digits
+template <typename T>
+static std::optional<Rational> FromShortestDecimal(const T Value)
+{
+	if (!std::isfinite(Value))
+	{
+		return std::nullopt;
+	}
+
+	char Buffer[128];
+	const std::to_chars_result Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+
+	return Rational::FromDecimal(std::string_view(Buffer, Result.ptr - Buffer));
+}
+
+[[nodiscard]] std::optional<Rational> Rational::FromFloat(const float Value)
+{
+	return FromShortestDecimal(Value);
+}
+
+[[nodiscard]] std::optional<Rational> Rational::FromFloat(const double Value)
+{
+	return FromShortestDecimal(Value);
+}
+
+[[nodiscard]] std::optional<Rational> Rational::FromFloat(const long double Value)
+{
+	return FromShortestDecimal(Value);
+}
+
+[[nodiscard]] std::optional<Rational> Rational::FromDecimal(const std::string_view Text)
+{
+	std::string Digits;
+	int32_t Exponent = 0;
+	bool IsNegative = false;
+	bool IsFraction = false;
+
+	for (size_t Index = 0; Index < Text.size(); ++Index)
+	{
+		const char Character = Text[Index];
+
+		if (Character == '-')
+		{
+			IsNegative = true;
+		}
+		else if (Character == '.')
+		{
+			IsFraction = true;
+		}
+		else if (Character == 'e' || Character == 'E')
+		{
+			std::string ExponentText(Text.substr(Index + 1 < Text.size() && Text[Index + 1] == '+' ? Index + 2 : Index + 1));
+			std::erase(ExponentText, '_');
+
+			// Compared without std::abs, which is undefined for the most negative value
+			int64_t WrittenExponent = 0;
+
+			if (std::from_chars(ExponentText.data(), ExponentText.data() + ExponentText.size(), WrittenExponent).ec != std::errc()
+			    || WrittenExponent < -MAX_DECIMAL_EXPONENT || WrittenExponent > MAX_DECIMAL_EXPONENT)
+			{
+				return std::nullopt;
+			}
+
+			Exponent += static_cast<int32_t>(WrittenExponent);
+			break;
+		}
+		else if (Character != '_')
+		{
+			Digits += Character;
+
+			if (IsFraction)
+			{
+				Exponent--;
+			}
+		}
+	}
+
+	// The digits after the point count against the limit too, "0.000...1" is as far out as "1e-5000"
+	if (std::abs(Exponent) > MAX_DECIMAL_EXPONENT)
+	{
+		return std::nullopt;
+	}
+
+	// Typical literals fit in int64_t, the power of ten as well
+	if (Digits.size() <= 18 && std::abs(Exponent) <= 18)
+	{
+		int64_t SmallMantissa = 0;
+		int64_t SmallScale = 1;
+
+		std::from_chars(Digits.data(), Digits.data() + Digits.size(), SmallMantissa);
+
+		for (int32_t Index = 0; Index < std::abs(Exponent); ++Index)
+		{
+			SmallScale *= 10;
+		}
+
+		if (IsNegative)
+		{
+			SmallMantissa = -SmallMantissa;
+		}
+
+		if (Exponent >= 0)
+		{
+			return Rational(SmallMantissa).MultipliedBy(Rational(SmallScale));
+		}
+
+		return Rational(SmallMantissa).DividedBy(Rational(SmallScale));
+	}
+
+	BigInt Mantissa;
+
+	for (const char Digit : Digits)
+	{
+		Mantissa = Mantissa.MultipliedBy(BigInt(int64_t{ 10 })).AddedTo(BigInt(static_cast<int64_t>(Digit - '0')));
+	}
+
+	BigInt Scale(int64_t{ 1 });
+
+	for (int32_t Index = 0; Index < std::abs(Exponent); ++Index)
+	{
+		Scale = Scale.MultipliedBy(BigInt(int64_t{ 10 }));
+	}
+
+	if (IsNegative)
+	{
+		Mantissa = Mantissa.Negated();
+	}
+
+	if (Exponent >= 0)
+	{
+		return Rational(Mantissa.MultipliedBy(Scale), BigInt(int64_t{ 1 }));
+	}
+
+	return Rational(Mantissa, Scale);
+}
+
+[[nodiscard]] Rational Rational::AddedTo(const Rational& Other) const
+{
+	if (!Big && !Other.Big)
+	{
+		int64_t Result;
+
+		// Integers, no gcd needed
+		if (Denominator == 1 && Other.Denominator == 1)
+		{
+			if (CheckedAdd(Numerator, Other.Numerator, Result))
+			{
+				return Rational(Result);
+			}
+		}
+		else
+		{
+			// a/b + c/d = (a*(d/g) + c*(b/g)) / (b/g*d) with g = gcd(b, d), reduced by gcd(numerator, g) afterwards
+			const int64_t Divisor = std::gcd(Denominator, Other.Denominator);
+			int64_t LeftTerm, RightTerm, Sum, ResultDenominator;
+
+			if (CheckedMultiply(Numerator, Other.Denominator / Divisor, LeftTerm) && CheckedMultiply(Other.Numerator, Denominator / Divisor, RightTerm)
+			    && CheckedAdd(LeftTerm, RightTerm, Sum))
+			{
+				const int64_t Reduction = std::gcd(Sum, Divisor);
+
+				if (CheckedMultiply(Denominator / Divisor, Other.Denominator / Reduction, ResultDenominator))
+				{
+					Rational Small;
+					Small.Numerator = Sum / Reduction;
+					Small.Denominator = Sum == 0 ? 1 : ResultDenominator;
+					return Small;
+				}
+			}
+		}
+	}
+
+	return {
+		GetBigNumerator().MultipliedBy(Other.GetBigDenominator()).AddedTo(Other.GetBigNumerator().MultipliedBy(GetBigDenominator())),
+		GetBigDenominator().MultipliedBy(Other.GetBigDenominator())
+	};
+}
+
+[[nodiscard]] Rational Rational::SubtractedBy(const Rational& Other) const
+{
+	return AddedTo(Other.Negated());
+}
+
+[[nodiscard]] Rational Rational::MultipliedBy(const Rational& Other) const
+{
+	if (!Big && !Other.Big)
+	{
+		int64_t ResultNumerator, ResultDenominator;
+
+		// Integers, no gcd needed
+		if (Denominator == 1 && Other.Denominator == 1)
+		{
+			if (CheckedMultiply(Numerator, Other.Numerator, ResultNumerator))
+			{
+				return Rational(ResultNumerator);
+			}
+		}
+		else
+		{
+			// Cross reduce first so the products stay small and the result is already normalized
+			const int64_t LeftDivisor = std::gcd(Numerator, Other.Denominator);
+			const int64_t RightDivisor = std::gcd(Other.Numerator, Denominator);
+
+			if (CheckedMultiply(Numerator / LeftDivisor, Other.Numerator / RightDivisor, ResultNumerator)
+			    && CheckedMultiply(Denominator / RightDivisor, Other.Denominator / LeftDivisor, ResultDenominator))
+			{
+				Rational Small;
+				Small.Numerator = ResultNumerator;
+				Small.Denominator = ResultNumerator == 0 ? 1 : ResultDenominator;
+				return Small;
+			}
+		}
+	}
+
+	return {
+		GetBigNumerator().MultipliedBy(Other.GetBigNumerator()),
+		GetBigDenominator().MultipliedBy(Other.GetBigDenominator())
+	};
+}
+
+[[nodiscard]] Rational Rational::DividedBy(const Rational& Other) const
+{
+	// Multiply by the reciprocal, the sign moves to the numerator
+	Rational Reciprocal;
+
+	if (Other.Big)
+	{
+		return MultipliedBy(Rational(Other.Big->Denominator, Other.Big->Numerator));
+	}
+
+	Reciprocal.Numerator = Other.Numerator < 0 ? -Other.Denominator : Other.Denominator;
+	Reciprocal.Denominator = Other.Numerator < 0 ? -Other.Numerator : Other.Numerator;
+
+	return MultipliedBy(Reciprocal);
+}
+
+[[nodiscard]] Rational Rational::Negated() const
+{
+	if (Big)
+	{
+		return { Big->Numerator.Negated(), Big->Denominator };
+	}
+
+	Rational Result;
+	Result.Numerator = -Numerator;
+	Result.Denominator = Denominator;
+	return Result;
+}
+
+[[nodiscard]] bool Rational::IsZero() const
+{
+	return !Big && Numerator == 0;
+}
+
+[[nodiscard]] bool Rational::IsInteger() const
+{
+	return Big ? Big->Denominator.GetBitLength() == 1 : Denominator == 1;
+}
+
+[[nodiscard]] long double Rational::ToLongDouble() const
+{
+	if (!Big)
+	{
+		return static_cast<long double>(Numerator) / static_cast<long double>(Denominator);
+	}
+
+	// Each part keeps its top 128 bits so neither overflows the conversion or drops to 0, the dropped powers of two
+	// are applied to the quotient instead, which then only overflows or underflows when the value itself does
+	constexpr uint32_t KEPT_BITS = 128;
+
+	const uint32_t NumeratorShift = std::max(Big->Numerator.GetBitLength(), KEPT_BITS) - KEPT_BITS;
+	const uint32_t DenominatorShift = std::max(Big->Denominator.GetBitLength(), KEPT_BITS) - KEPT_BITS;
+	const long double Quotient = Big->Numerator.ShiftedRight(NumeratorShift).ToLongDouble() / Big->Denominator.ShiftedRight(DenominatorShift).ToLongDouble();
+
+	return std::ldexp(Quotient, static_cast<int32_t>(NumeratorShift) - static_cast<int32_t>(DenominatorShift));
+}
+
+[[nodiscard]] std::string Rational::ToString() const
+{
+	if (!Big)
+	{
+		return Denominator == 1 ? std::format("{}", Numerator) : std::format("{}/{}", Numerator, Denominator);
+	}
+
+	if (IsInteger())
+	{
+		return GetBigNumerator().ToString();
+	}
+
+	return std::format("{}/{}", GetBigNumerator().ToString(), GetBigDenominator().ToString());
+}
+
+[[nodiscard]] BigInt Rational::GetBigNumerator() const
+{
+	return Big ? Big->Numerator : BigInt(Numerator);
+}
+
+[[nodiscard]] BigInt Rational::GetBigDenominator() const
+{
+	return Big ? Big->Denominator : BigInt(Denominator);
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include "BigInt.h"
+
+/*
+ * Exact fraction, always normalized (gcd of 1, positive denominator). Values that fit are kept as two int64_t
+ * and only move to BigInt when an operation overflows, results that fit again move back. Operations on two
+ * integers (denominator 1) skip the gcd entirely.
+ */
+class Rational
+{
+	// Access functions
+public:
+	// Zero
+	Rational()
+		: Numerator(0), Denominator(1)
+	{
+	}
+
+	explicit Rational(int64_t Value);
+
+	// Denominator must not be zero
+	Rational(const BigInt& Numerator, const BigInt& Denominator);
+
+	// Exponents of FromDecimal beyond this have no value, every floating-point type is infinity or zero there
+	static constexpr int32_t MAX_DECIMAL_EXPONENT = 5000;
+
+	// Exact value of the shortest decimal that round-trips in the type of Value, so the literal 0.1 becomes 1/10
+	// with every number policy. No value for inf or nan.
+	[[nodiscard]] static std::optional<Rational> FromFloat(float Value);
+	[[nodiscard]] static std::optional<Rational> FromFloat(double Value);
+	[[nodiscard]] static std::optional<Rational> FromFloat(long double Value);
+
+	// Exact value of a float literal as written, [-]digits[.digits][(e|E)[+|-]digits] with '_' separators, also
+	// when it overflows the floating-point type
+	[[nodiscard]] static std::optional<Rational> FromDecimal(std::string_view Text);
+
+	[[nodiscard]] Rational AddedTo(const Rational& Other) const;
+	[[nodiscard]] Rational SubtractedBy(const Rational& Other) const;
+	[[nodiscard]] Rational MultipliedBy(const Rational& Other) const;
+
+	// Other must not be zero
+	[[nodiscard]] Rational DividedBy(const Rational& Other) const;
+
+	[[nodiscard]] Rational Negated() const;
+
+	[[nodiscard]] bool IsZero() const;
+	[[nodiscard]] bool IsInteger() const;
+
+	[[nodiscard]] long double ToLongDouble() const;
+
+	// "n" for integers, "n/d" otherwise
+	[[nodiscard]] std::string ToString() const;
+
+	// Protected fields and functions
+protected:
+	struct BigFraction
+	{
+		BigInt Numerator;
+		BigInt Denominator;
+	};
+
+	[[nodiscard]] BigInt GetBigNumerator() const;
+	[[nodiscard]] BigInt GetBigDenominator() const;
+
+	// Small fields, INT64_MIN is never stored so negating cannot overflow. Unused while Big is set.
+	int64_t Numerator;
+	int64_t Denominator;
+
+	// Shared because big values are immutable
+	std::shared_ptr<const BigFraction> Big;
+};
@@ -0,0 +1,123 @@
+﻿#include "Pch.h"
+
+#include "RationalInterpreter.h"
+#include "ErrorManager.h"
+#include "EvaluationBudget.h"
+
+namespace RationalInterpreter
+{
+	std::optional<Rational> Visit(const SyntaxTreeView& Tree, const uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget, const std::string_view Source)
+	{
+		const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+
+		if (Budget != nullptr && !Budget->Spend(Errors, Node.Start, Node.End))
+		{
+			return Rational();
+		}
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_BINARY_OP:
+			return VisitBinaryOperator(Tree, Node, Errors, Budget, Source);
+
+		case NODE_TYPE_NUMBER:
+			return VisitNumberNode(Tree, Node, Source);
+
+		case NODE_TYPE_UNARY_OP:
+			return VisitUnaryOperator(Tree, Node, Errors, Budget, Source);
+
+		case NODE_TYPE_ERROR:
+			break;
+		}
+
+		return Rational();
+	}
+
+	std::optional<Rational> VisitNumberNode(const SyntaxTreeView& Tree, const SyntaxNode& Node, const std::string_view Source)
+	{
+		const Number& Literal = Tree.GetLiteral(Node);
+
+		if (Literal.IsInt)
+		{
+			return Rational(Literal.IntValue);
+		}
+
+		if (Node.End <= static_cast<int32_t>(Source.size()))
+		{
+			return Rational::FromDecimal(Source.substr(Node.Start, Node.End - Node.Start));
+		}
+
+		return Rational::FromFloat(Literal.FloatValue);
+	}
+
+	std::optional<Rational> VisitBinaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, const std::string_view Source)
+	{
+		// Recovered parse, evaluate the operand that is present so half-typed input still gives a result
+		if (Tree.GetNode(Node.Right).Type == NODE_TYPE_ERROR)
+		{
+			return Visit(Tree, Node.Left, Errors, Budget, Source);
+		}
+
+		if (Tree.GetNode(Node.Left).Type == NODE_TYPE_ERROR)
+		{
+			return Visit(Tree, Node.Right, Errors, Budget, Source);
+		}
+
+		const std::optional<Rational> Left = Visit(Tree, Node.Left, Errors, Budget, Source);
+
+		if (!Left || Errors.HasErrors())
+		{
+			return Left ? std::optional(Rational()) : std::nullopt;
+		}
+
+		const std::optional<Rational> Right = Visit(Tree, Node.Right, Errors, Budget, Source);
+
+		if (!Right || Errors.HasErrors())
+		{
+			return Right ? std::optional(Rational()) : std::nullopt;
+		}
+
+		switch (Node.Operator)
+		{
+		case TYPE_PLUS:
+			return Left->AddedTo(*Right);
+
+		case TYPE_MINUS:
+			return Left->SubtractedBy(*Right);
+
+		case TYPE_MUL:
+			return Left->MultipliedBy(*Right);
+
+		case TYPE_DIV:
+			if (Right->IsZero())
+			{
+				Errors.ReportError(ERROR_DIVISION_BY_ZERO, Node.Start, Node.End);
+				return Rational();
+			}
+
+			return Left->DividedBy(*Right);
+
+		default:
+			break;
+		}
+
+		return Rational();
+	}
+
+	std::optional<Rational> VisitUnaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget, const std::string_view Source)
+	{
+		const std::optional<Rational> Child = Visit(Tree, Node.Left, Errors, Budget, Source);
+
+		if (!Child || Errors.HasErrors())
+		{
+			return Child ? std::optional(Rational()) : std::nullopt;
+		}
+
+		if (Node.Operator == TYPE_MINUS)
+		{
+			return Child->Negated();
+		}
+
+		return Child;
+	}
+}
@@ -0,0 +1,20 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+#include "Rational.h"
+
+class ErrorManager;
+class EvaluationBudget;
+
+// Exact evaluation mode. Same tree walk and error handling as the Interpreter but on Rational, so 1/3*3 is exactly 1.
+namespace RationalInterpreter
+{
+	// Returns std::nullopt when a literal has no exact value (it overflowed to infinity), the Interpreter has to be used then
+	// Every visited node is charged to Budget when one is given. Source is the text the tree was parsed from, float
+	// literals are then read exactly as written instead of from their rounded value, so "1e300" has a value even
+	// when Number is built on floats. Trees without their text (an ExpressionCache) pass none.
+	std::optional<Rational> Visit(const SyntaxTreeView& Tree, uint32_t NodeIndex, ErrorManager& Errors, EvaluationBudget* Budget = nullptr, std::string_view Source = {});
+	std::optional<Rational> VisitNumberNode(const SyntaxTreeView& Tree, const SyntaxNode& Node, std::string_view Source = {});
+	std::optional<Rational> VisitBinaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget = nullptr, std::string_view Source = {});
+	std::optional<Rational> VisitUnaryOperator(const SyntaxTreeView& Tree, const SyntaxNode& Node, ErrorManager& Errors, EvaluationBudget* Budget = nullptr, std::string_view Source = {});
+}
@@ -0,0 +1,67 @@
+﻿#include "Pch.h"
+
+#include "Summation.h"
+
+#include <cmath>
+
+namespace Summation
+{
+	// Blocks this small are added lane by lane, the lanes are independent so the compiler can keep them in one
+	// vector register where FloatType allows it
+	static constexpr size_t PAIRWISE_BLOCK_SIZE = 32;
+	static constexpr size_t LANE_COUNT = 4;
+
+	[[nodiscard]] Number::FloatType SumPairwise(const std::span<const Number::FloatType> Values)
+	{
+		if (Values.size() > PAIRWISE_BLOCK_SIZE)
+		{
+			const size_t Half = Values.size() / 2;
+			return SumPairwise(Values.first(Half)) + SumPairwise(Values.subspan(Half));
+		}
+
+		// -0.0 is the identity of addition, 0.0 would turn an all negative zero sum positive
+		Number::FloatType Lanes[LANE_COUNT] = { -0.0f, -0.0f, -0.0f, -0.0f };
+		size_t Index = 0;
+
+		for (; Index + LANE_COUNT <= Values.size(); Index += LANE_COUNT)
+		{
+			for (size_t Lane = 0; Lane < LANE_COUNT; ++Lane)
+			{
+				Lanes[Lane] += Values[Index + Lane];
+			}
+		}
+
+		for (; Index < Values.size(); ++Index)
+		{
+			Lanes[0] += Values[Index];
+		}
+
+		return (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]);
+	}
+
+	[[nodiscard]] Number::FloatType SumCompensated(const std::span<const Number::FloatType> Values)
+	{
+		Number::FloatType Sum = -0.0f;
+		Number::FloatType Compensation = 0;
+
+		for (const Number::FloatType Value : Values)
+		{
+			const Number::FloatType NewSum = Sum + Value;
+
+			// The low-order bits lost by the addition, taken from whichever operand is smaller
+			if (std::abs(Sum) >= std::abs(Value))
+			{
+				Compensation += (Sum - NewSum) + Value;
+			}
+			else
+			{
+				Compensation += (Value - NewSum) + Sum;
+			}
+
+			Sum = NewSum;
+		}
+
+		// An infinite sum turns the compensation into NaN, and adding a zero one could only change the sign of a zero
+		return std::isfinite(Sum) && Compensation != 0 ? Sum + Compensation : Sum;
+	}
+}
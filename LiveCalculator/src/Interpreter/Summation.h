@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include "Number.h"
+
+enum ESumMode : uint8_t
+{
+	SUM_MODE_STRICT,     // Left to right as written, the default everywhere
+	SUM_MODE_PAIRWISE,   // Balanced halves over independent lanes, vectorizes and the error grows with log(n)
+	SUM_MODE_COMPENSATED // Kahan-Neumaier, about as accurate as adding in twice the precision
+};
+
+/*
+ * Floating-point sums of the '+'/'-' chains Interpreter::Visit flattens outside of SUM_MODE_STRICT. Both regroup
+ * the additions, so they can round differently from left to right evaluation and are only used when asked for.
+ * Integer operands never get here, they wrap in two's complement and give the same sum in any order.
+ */
+namespace Summation
+{
+	// Shorter chains are always added left to right
+	inline constexpr size_t MIN_FLAT_TERMS = 8;
+
+	[[nodiscard]] Number::FloatType SumPairwise(std::span<const Number::FloatType> Values);
+	[[nodiscard]] Number::FloatType SumCompensated(std::span<const Number::FloatType> Values);
+}
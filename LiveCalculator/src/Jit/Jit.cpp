@@ -0,0 +1,405 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Jit.h"
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LC_JIT_SUPPORTED 1
+#else
+#define LC_JIT_SUPPORTED 0
+#endif
+
+// Written by the compiled code
+struct JitResult
+{
+	int64_t IntValue;
+	double FloatValue;
+};
+
+using JitFunction = int32_t (*)(JitResult* Result);
+
+/*
+ * Register use of the generated code:
+ *		rax / xmm0 - value of the subtree that was just emitted
+ *		rcx / xmm1 - left operand popped from the stack
+ *		rbx        - stack pointer on entry, restored on exit and on bail out
+ *		rdx        - result pointer in the epilogue
+ */
+class CodeBuffer
+{
+public:
+	void Emit(const std::initializer_list<uint8_t> Bytes)
+	{
+		Code.insert(Code.end(), Bytes);
+	}
+
+	void EmitInt64(const int64_t Value)
+	{
+		for (int32_t Shift = 0; Shift < 64; Shift += 8)
+		{
+			Code.push_back(static_cast<uint8_t>(static_cast<uint64_t>(Value) >> Shift));
+		}
+	}
+
+	// Emits a rel32 jump to the bail out path, patched once the epilogue is written
+	void EmitBailJump(const std::initializer_list<uint8_t> Opcode)
+	{
+		Emit(Opcode);
+		BailPatches.push_back(Code.size());
+		Emit({ 0, 0, 0, 0 });
+	}
+
+	void PatchBailJumps(const size_t BailOffset)
+	{
+		for (const size_t Patch : BailPatches)
+		{
+			const int32_t Relative = static_cast<int32_t>(BailOffset - (Patch + 4));
+			memcpy(&Code[Patch], &Relative, sizeof(Relative));
+		}
+	}
+
+	std::vector<uint8_t> Code;
+	std::vector<size_t> BailPatches;
+};
+
+// Emits code leaving the value in rax (int) or xmm0 (float), OutIsInt tells which
+static bool EmitNode(CodeBuffer& Buffer, const SyntaxTree& Tree, const uint32_t NodeIndex, bool& OutIsInt)
+{
+	const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+
+	switch (Node.Type)
+	{
+	case NODE_TYPE_NUMBER:
+	{
+		const Number& Literal = Tree.GetLiteral(Node);
+		OutIsInt = Literal.IsInt;
+
+		if (Literal.IsInt)
+		{
+			Buffer.Emit({ 0x48, 0xB8 }); // mov rax, imm64
+			Buffer.EmitInt64(Literal.IntValue);
+		}
+		else
+		{
+			const double Value = static_cast<double>(Literal.FloatValue);
+			int64_t Bits;
+			memcpy(&Bits, &Value, sizeof(Bits));
+
+			Buffer.Emit({ 0x48, 0xB8 }); // mov rax, imm64
+			Buffer.EmitInt64(Bits);
+			Buffer.Emit({ 0x66, 0x48, 0x0F, 0x6E, 0xC0 }); // movq xmm0, rax
+		}
+
+		return true;
+	}
+
+	case NODE_TYPE_UNARY_OP:
+	{
+		if (!EmitNode(Buffer, Tree, Node.Left, OutIsInt))
+		{
+			return false;
+		}
+
+		if (Node.Operator != TYPE_MINUS)
+		{
+			return true;
+		}
+
+		if (OutIsInt)
+		{
+			Buffer.Emit({ 0x48, 0xF7, 0xD8 }); // neg rax
+			Buffer.EmitBailJump({ 0x0F, 0x80 }); // jo bail
+		}
+		else
+		{
+			constexpr double MINUS_ONE = -1.0;
+			int64_t Bits;
+			memcpy(&Bits, &MINUS_ONE, sizeof(Bits));
+
+			Buffer.Emit({ 0x48, 0xB8 }); // mov rax, imm64
+			Buffer.EmitInt64(Bits);
+			Buffer.Emit({ 0x66, 0x48, 0x0F, 0x6E, 0xC8 }); // movq xmm1, rax
+			Buffer.Emit({ 0xF2, 0x0F, 0x59, 0xC1 }); // mulsd xmm0, xmm1
+		}
+
+		return true;
+	}
+
+	case NODE_TYPE_BINARY_OP:
+	{
+		const ETokenType Operator = Node.Operator;
+		bool LeftIsInt;
+		bool RightIsInt;
+
+		// Left operand is kept on the stack while the right one is emitted
+		if (!EmitNode(Buffer, Tree, Node.Left, LeftIsInt))
+		{
+			return false;
+		}
+
+		if (LeftIsInt)
+		{
+			Buffer.Emit({ 0x50 }); // push rax
+		}
+		else
+		{
+			Buffer.Emit({ 0x48, 0x83, 0xEC, 0x08 }); // sub rsp, 8
+			Buffer.Emit({ 0xF2, 0x0F, 0x11, 0x04, 0x24 }); // movsd [rsp], xmm0
+		}
+
+		if (!EmitNode(Buffer, Tree, Node.Right, RightIsInt))
+		{
+			return false;
+		}
+
+		if (LeftIsInt)
+		{
+			Buffer.Emit({ 0x59 }); // pop rcx
+		}
+		else
+		{
+			Buffer.Emit({ 0xF2, 0x0F, 0x10, 0x0C, 0x24 }); // movsd xmm1, [rsp]
+			Buffer.Emit({ 0x48, 0x83, 0xC4, 0x08 }); // add rsp, 8
+		}
+
+		// Same check as the interpreter, done on the divisor before any promotion
+		if (Operator == TYPE_DIV)
+		{
+			if (RightIsInt)
+			{
+				Buffer.Emit({ 0x48, 0x85, 0xC0 }); // test rax, rax
+				Buffer.EmitBailJump({ 0x0F, 0x84 }); // jz bail
+			}
+			else
+			{
+				Buffer.Emit({ 0x66, 0x0F, 0x57, 0xD2 }); // xorpd xmm2, xmm2
+				Buffer.Emit({ 0x66, 0x0F, 0x2E, 0xC2 }); // ucomisd xmm0, xmm2
+				Buffer.Emit({ 0x7A, 0x06 }); // jp +6, NaN is not zero
+				Buffer.EmitBailJump({ 0x0F, 0x84 }); // je bail
+			}
+		}
+
+		OutIsInt = Operator != TYPE_DIV && LeftIsInt && RightIsInt;
+
+		if (OutIsInt)
+		{
+			switch (Operator)
+			{
+			case TYPE_PLUS:
+				Buffer.Emit({ 0x48, 0x01, 0xC1 }); // add rcx, rax
+				break;
+
+			case TYPE_MINUS:
+				Buffer.Emit({ 0x48, 0x29, 0xC1 }); // sub rcx, rax
+				break;
+
+			case TYPE_MUL:
+				Buffer.Emit({ 0x48, 0x0F, 0xAF, 0xC8 }); // imul rcx, rax
+				break;
+
+			default:
+				return false;
+			}
+
+			Buffer.EmitBailJump({ 0x0F, 0x80 }); // jo bail
+			Buffer.Emit({ 0x48, 0x89, 0xC8 }); // mov rax, rcx
+
+			return true;
+		}
+
+		// Promote whichever side is still an int
+		if (LeftIsInt)
+		{
+			Buffer.Emit({ 0xF2, 0x48, 0x0F, 0x2A, 0xC9 }); // cvtsi2sd xmm1, rcx
+		}
+
+		if (RightIsInt)
+		{
+			Buffer.Emit({ 0xF2, 0x48, 0x0F, 0x2A, 0xC0 }); // cvtsi2sd xmm0, rax
+		}
+
+		switch (Operator)
+		{
+		case TYPE_PLUS:
+			Buffer.Emit({ 0xF2, 0x0F, 0x58, 0xC8 }); // addsd xmm1, xmm0
+			break;
+
+		case TYPE_MINUS:
+			Buffer.Emit({ 0xF2, 0x0F, 0x5C, 0xC8 }); // subsd xmm1, xmm0
+			break;
+
+		case TYPE_MUL:
+			Buffer.Emit({ 0xF2, 0x0F, 0x59, 0xC8 }); // mulsd xmm1, xmm0
+			break;
+
+		case TYPE_DIV:
+			Buffer.Emit({ 0xF2, 0x0F, 0x5E, 0xC8 }); // divsd xmm1, xmm0
+			break;
+
+		default:
+			return false;
+		}
+
+		Buffer.Emit({ 0x66, 0x0F, 0x28, 0xC1 }); // movapd xmm0, xmm1
+
+		return true;
+	}
+
+	case NODE_TYPE_ERROR:
+		break;
+	}
+
+	return false;
+}
+
+static void* AllocateExecutable(const std::vector<uint8_t>& Code)
+{
+#ifdef _WIN32
+	void* Memory = VirtualAlloc(nullptr, Code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+	if (Memory == nullptr)
+	{
+		return nullptr;
+	}
+
+	memcpy(Memory, Code.data(), Code.size());
+
+	DWORD OldProtection;
+
+	if (!VirtualProtect(Memory, Code.size(), PAGE_EXECUTE_READ, &OldProtection))
+	{
+		VirtualFree(Memory, 0, MEM_RELEASE);
+		return nullptr;
+	}
+
+	FlushInstructionCache(GetCurrentProcess(), Memory, Code.size());
+#else
+	void* Memory = mmap(nullptr, Code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (Memory == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	memcpy(Memory, Code.data(), Code.size());
+
+	if (mprotect(Memory, Code.size(), PROT_READ | PROT_EXEC) != 0)
+	{
+		munmap(Memory, Code.size());
+		return nullptr;
+	}
+#endif
+
+	return Memory;
+}
+
+CompiledExpression::CompiledExpression(void* Code, const size_t CodeSize, const bool ResultIsInt)
+	: Code(Code),
+	  CodeSize(CodeSize),
+	  ResultIsInt(ResultIsInt)
+{
+}
+
+CompiledExpression::~CompiledExpression()
+{
+#ifdef _WIN32
+	VirtualFree(Code, 0, MEM_RELEASE);
+#else
+	munmap(Code, CodeSize);
+#endif
+}
+
+[[nodiscard]] bool CompiledExpression::Run(Number& OutResult) const
+{
+	JitResult Result{};
+
+	if (reinterpret_cast<JitFunction>(Code)(&Result) != 0)
+	{
+		return false;
+	}
+
+	if (ResultIsInt)
+	{
+		OutResult = Number(Result.IntValue);
+	}
+	else
+	{
+		OutResult = Number(static_cast<Number::FloatType>(Result.FloatValue));
+	}
+
+	return true;
+}
+
+namespace Jit
+{
+	[[nodiscard]] std::unique_ptr<CompiledExpression> Compile(const SyntaxTree& Tree, const uint32_t Root)
+	{
+		// SSE2 doubles only give the interpreter's results where the numeric policy's float is a double
+		if (!LC_JIT_SUPPORTED || sizeof(Number::FloatType) != sizeof(double))
+		{
+			return nullptr;
+		}
+
+		CodeBuffer Buffer;
+
+		// Prologue, keep the result pointer and the entry stack pointer
+		Buffer.Emit({ 0x53 }); // push rbx
+#ifdef _WIN32
+		Buffer.Emit({ 0x51 }); // push rcx
+#else
+		Buffer.Emit({ 0x57 }); // push rdi
+#endif
+		Buffer.Emit({ 0x48, 0x89, 0xE3 }); // mov rbx, rsp
+
+		bool ResultIsInt;
+
+		if (!EmitNode(Buffer, Tree, Root, ResultIsInt))
+		{
+			return nullptr;
+		}
+
+		// Epilogue, store the result and return 0
+		Buffer.Emit({ 0x48, 0x89, 0xDC }); // mov rsp, rbx
+		Buffer.Emit({ 0x5A }); // pop rdx
+		Buffer.Emit({ 0x5B }); // pop rbx
+		Buffer.Emit({ 0x48, 0x89, 0x02 }); // mov [rdx], rax
+		Buffer.Emit({ 0xF2, 0x0F, 0x11, 0x42, 0x08 }); // movsd [rdx + 8], xmm0
+		Buffer.Emit({ 0x31, 0xC0 }); // xor eax, eax
+		Buffer.Emit({ 0xC3 }); // ret
+
+		// Bail out, unwind whatever was pushed and return 1
+		Buffer.PatchBailJumps(Buffer.Code.size());
+		Buffer.Emit({ 0x48, 0x89, 0xDC }); // mov rsp, rbx
+		Buffer.Emit({ 0x5A }); // pop rdx
+		Buffer.Emit({ 0x5B }); // pop rbx
+		Buffer.Emit({ 0xB8, 0x01, 0x00, 0x00, 0x00 }); // mov eax, 1
+		Buffer.Emit({ 0xC3 }); // ret
+
+		void* Code = AllocateExecutable(Buffer.Code);
+
+		if (Code == nullptr)
+		{
+			return nullptr;
+		}
+
+		return std::make_unique<CompiledExpression>(Code, Buffer.Code.size(), ResultIsInt);
+	}
+
+	Number Evaluate(const CompiledExpression* Expression, const SyntaxTree& Tree, const uint32_t Root, ErrorManager& Errors)
+	{
+		Number Result(int64_t{ 0 });
+
+		if (Expression != nullptr && Expression->Run(Result))
+		{
+			return Result;
+		}
+
+		return Interpreter::Visit(Tree, Root, Errors);
+	}
+}
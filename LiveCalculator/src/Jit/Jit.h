@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include "../Parser/NodeTypes.h"
+#include "../Interpreter/Number.h"
+
+class ErrorManager;
+
+// Executable x86-64 code for one expression, owns its pages
+class CompiledExpression
+{
+public:
+	CompiledExpression(void* Code, size_t CodeSize, bool ResultIsInt);
+	~CompiledExpression();
+
+	CompiledExpression(const CompiledExpression&) = delete;
+	CompiledExpression& operator=(const CompiledExpression&) = delete;
+
+	// Returns false when the code bailed out on overflow or division by zero, the interpreter then has to produce the result
+	[[nodiscard]] bool Run(Number& OutResult) const;
+
+	// Protected fields and functions
+protected:
+	void* Code;
+	size_t CodeSize;
+	bool ResultIsInt;
+};
+
+/*
+ * Native backend for expressions that are evaluated many times. Types are known per node at compile time
+ * (int unless a float literal or a division is involved), so int subtrees run on general purpose registers
+ * with overflow checks and float subtrees on SSE2 doubles.
+ */
+namespace Jit
+{
+	// Returns nullptr when the tree contains errors or the host is not x86-64 or Number is not built on doubles, callers then use the interpreter.
+	[[nodiscard]] std::unique_ptr<CompiledExpression> Compile(const SyntaxTree& Tree, uint32_t Root);
+
+	// Runs the compiled code if there is any, falls back to Interpreter::Visit otherwise or when the code bails out
+	Number Evaluate(const CompiledExpression* Expression, const SyntaxTree& Tree, uint32_t Root, ErrorManager& Errors);
+}
@@ -3,87 +3,130 @@
 
 #include "Lexer.h"
 #include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Trace.h"
 
-std::string* Lexer::CurrentInput = nullptr;
-Position Lexer::CurrentPosition(-1, 0, -1, "");
-char Lexer::CurrentCharacter = '\0';
-
-std::vector<Token> Lexer::GetTokens(std::string& Input)
+// The <cctype> classifiers take an unsigned char value, a negative char from UTF-8 input is undefined behaviour
+static bool IsDigit(const char Character)
 {
-	ErrorManager::Clear();
+	return isdigit(static_cast<unsigned char>(Character)) != 0;
+}
 
-	std::vector<Token> Result;
+static bool IsHexDigit(const char Character)
+{
+	return isxdigit(static_cast<unsigned char>(Character)) != 0;
+}
 
-	CurrentInput = &Input;
-	CurrentPosition = Position(-1, 0, -1, Input);
-	CurrentCharacter = '\0';
+Lexer::Lexer(const std::string_view Input, ErrorManager& Errors, EvaluationBudget* Budget)
+	: Lexer(Input, Errors, 0, static_cast<int32_t>(Input.size()), Budget)
+{
+}
 
+Lexer::Lexer(const std::string_view Input, ErrorManager& Errors, const int32_t BeginIndex, const int32_t EndIndex, EvaluationBudget* Budget)
+	: Input(Input),
+	  EndIndex(EndIndex),
+	  Errors(Errors),
+	  Budget(Budget),
+	  CurrentPosition(BeginIndex - 1, 0, BeginIndex - 1),
+	  CurrentCharacter('\0'),
+	  Failed(false)
+{
 	Advance();
 
+	if (Budget != nullptr && !Budget->CheckInputLength(Input.size(), Errors))
+	{
+		Failed = true;
+		CurrentCharacter = '\0';
+	}
+}
+
+std::pmr::vector<Token> Lexer::GetTokens(const std::string_view Input, ErrorManager& Errors, EvaluationBudget* Budget, std::pmr::memory_resource* Resource)
+{
+	WL_TRACE_SCOPE("Lex", Input.size());
+
+	std::pmr::vector<Token> Result(Resource);
+	Lexer Source(Input, Errors, Budget);
+
+	do
+	{
+		Result.push_back(Source.GetNextToken());
+	}
+	while (Result.back().Type != TYPE_EOF);
+
+	if (Source.HasFailed())
+	{
+		Result.clear();
+	}
+
+	return Result;
+}
+
+[[nodiscard]] Token Lexer::GetNextToken()
+{
+	if (Budget != nullptr && CurrentCharacter != '\0' && !Budget->Spend(Errors, CurrentPosition.Index, CurrentPosition.Index + 1))
+	{
+		Failed = true;
+		CurrentCharacter = '\0';
+	}
+
 	while (CurrentCharacter != '\0')
 	{
+		const Position StartPosition = CurrentPosition;
+
 		if (CurrentCharacter == ' ' || CurrentCharacter == '\t')
 		{
 			Advance();
+			continue;
 		}
-		else if (isdigit(CurrentCharacter))
-		{
-			Result.emplace_back(GetNumberToken());
-		}
-		else if (CurrentCharacter == '+')
-		{
-			Result.emplace_back(TYPE_PLUS, "", CurrentPosition);
-			Advance();
-		}
-		else if (CurrentCharacter == '-')
-		{
-			Result.emplace_back(TYPE_MINUS, "", CurrentPosition);
-			Advance();
-		}
-		else if (CurrentCharacter == '*')
-		{
-			Result.emplace_back(TYPE_MUL, "", CurrentPosition);
-			Advance();
-		}
-		else if (CurrentCharacter == '/')
-		{
-			Result.emplace_back(TYPE_DIV, "", CurrentPosition);
-			Advance();
-		}
-		else if (CurrentCharacter == '(')
-		{
-			Result.emplace_back(TYPE_LBRACKET, "", CurrentPosition);
-			Advance();
-		}
-		else if (CurrentCharacter == ')')
+
+		if (IsDigit(CurrentCharacter))
 		{
-			Result.emplace_back(TYPE_RBRACKET, "", CurrentPosition);
-			Advance();
+			return GetNumberToken();
 		}
-		else
+
+		ETokenType Type;
+
+		switch (CurrentCharacter)
 		{
-			const std::string ErrorStr = std::format("'{}'", CurrentCharacter);
-			const Position ErrorStartPosition = CurrentPosition;
+		case '+': Type = TYPE_PLUS; break;
+		case '-': Type = TYPE_MINUS; break;
+		case '*': Type = TYPE_MUL; break;
+		case '/': Type = TYPE_DIV; break;
+		case '(': Type = TYPE_LBRACKET; break;
+		case ')': Type = TYPE_RBRACKET; break;
 
-			// Advance so we can recapture m_Pos after it has moved forward
-			Advance();
+		default:
+			{
+				const char IllegalCharacter = CurrentCharacter;
+
+				// Advance so we can recapture the position after it has moved forward
+				Advance();
+
+				Errors.ReportError(ERROR_ILLEGAL_CHARACTER, StartPosition.Index, CurrentPosition.Index, IllegalCharacter);
+				Failed = true;
 
-			ErrorManager::SetLastError(Error("Illegal Character", ErrorStr, ErrorStartPosition, CurrentPosition));
-			return {};
+				// The rest of the input is not lexed, the stream ends where the error starts
+				CurrentPosition = StartPosition;
+				CurrentCharacter = '\0';
+
+				return { TYPE_EOF, {}, CurrentPosition };
+			}
 		}
+
+		Advance();
+		return { Type, {}, StartPosition };
 	}
 
-	Result.emplace_back(TYPE_EOF, "", CurrentPosition);
-	return Result;
+	return { TYPE_EOF, {}, CurrentPosition };
 }
 
 void Lexer::Advance()
 {
 	CurrentPosition.Advance(CurrentCharacter);
 
-	if (CurrentPosition.Index < static_cast<int32_t>(CurrentInput->size()))
+	if (CurrentPosition.Index < EndIndex)
 	{
-		CurrentCharacter = CurrentInput->at(CurrentPosition.Index);
+		CurrentCharacter = Input[CurrentPosition.Index];
 	}
 	else
 	{
@@ -91,37 +134,133 @@ void Lexer::Advance()
 	}
 }
 
+[[nodiscard]] char Lexer::PeekCharacter(const int32_t Offset) const
+{
+	const int32_t Index = CurrentPosition.Index + Offset;
+	return Index < EndIndex ? Input[Index] : '\0';
+}
+
 [[nodiscard]] Token Lexer::GetNumberToken()
 {
-	std::string NumberString;
-	int32_t PeriodCount = 0;
+	const Position StartPosition = CurrentPosition;
+
+	if (CurrentCharacter == '0' && (PeekCharacter(1) == 'x' || PeekCharacter(1) == 'X') && IsHexDigit(PeekCharacter(2)))
+	{
+		Advance();
+		Advance();
+		SkipDigits(IsHexDigit);
+
+		const std::string_view NumberString = Input.substr(StartPosition.Index, CurrentPosition.Index - StartPosition.Index);
+		return { TYPE_INT, NumberString, StartPosition, CurrentPosition, GetNumberValue<NumberPolicy>(NumberString.substr(2), TYPE_INT, 16) };
+	}
 
-	Position StartPosition = CurrentPosition;
+	ETokenType Type = TYPE_INT;
 
-	while (CurrentCharacter != '\0' && (isdigit(CurrentCharacter) || CurrentCharacter == '.'))
+	SkipDigits(IsDigit);
+
+	if (CurrentCharacter == '.')
+	{
+		Type = TYPE_FLOAT;
+		Advance();
+
+		if (IsDigit(CurrentCharacter))
+		{
+			SkipDigits(IsDigit);
+		}
+	}
+
+	if (CurrentCharacter == 'e' || CurrentCharacter == 'E')
 	{
-		if (CurrentCharacter == '.')
+		const char Next = PeekCharacter(1);
+
+		if (IsDigit(Next) || ((Next == '+' || Next == '-') && IsDigit(PeekCharacter(2))))
 		{
-			if (PeriodCount == 1)
+			Type = TYPE_FLOAT;
+			Advance();
+
+			if (!IsDigit(CurrentCharacter))
 			{
-				break;
+				Advance();
 			}
 
-			PeriodCount++;
-			NumberString += '.';
+			SkipDigits(IsDigit);
 		}
-		else
+	}
+
+	const std::string_view NumberString = Input.substr(StartPosition.Index, CurrentPosition.Index - StartPosition.Index);
+	return { Type, NumberString, StartPosition, CurrentPosition, GetNumberValue<NumberPolicy>(NumberString, Type, 10) };
+}
+
+// Skips a run of digits starting at CurrentCharacter, including '_' separators between two digits
+template <typename TPredicate>
+void Lexer::SkipDigits(const TPredicate IsDigitCharacter)
+{
+	while (IsDigitCharacter(CurrentCharacter) || (CurrentCharacter == '_' && IsDigitCharacter(PeekCharacter(1))))
+	{
+		Advance();
+	}
+}
+
+// Terminated copy of Digits without separators, in Buffer when it fits so lexing does not allocate
+static std::string_view CopyDigits(const std::string_view Digits, const std::span<char> Buffer, std::string& LongDigits)
+{
+	if (Digits.size() < Buffer.size())
+	{
+		char* End = std::remove_copy(Digits.begin(), Digits.end(), Buffer.data(), '_');
+		*End = '\0';
+
+		return { Buffer.data(), End };
+	}
+
+	LongDigits = Digits;
+	std::erase(LongDigits, '_');
+
+	return LongDigits;
+}
+
+template <typename TPolicy>
+[[nodiscard]] BasicNumber<TPolicy> Lexer::GetNumberValue(const std::string_view Digits, const ETokenType Type, const int32_t Base)
+{
+	char Buffer[128];
+	std::string LongDigits;
+
+	// Separators are rare, only copy when there are some
+	std::string_view Text = Digits;
+	bool IsCopy = false;
+
+	if (Digits.find('_') != std::string_view::npos)
+	{
+		Text = CopyDigits(Digits, Buffer, LongDigits);
+		IsCopy = true;
+	}
+
+	const char* First = Text.data();
+	const char* Last = First + Text.size();
+
+	if (Type == TYPE_INT)
+	{
+		int64_t Value;
+
+		// Saturate like strtoll
+		if (std::from_chars(First, Last, Value, Base).ec == std::errc::result_out_of_range)
 		{
-			NumberString += CurrentCharacter;
+			Value = INT64_MAX;
 		}
 
-		Advance();
+		return BasicNumber<TPolicy>(Value);
 	}
 
-	if (PeriodCount == 0)
+	typename TPolicy::FloatType Value;
+
+	// Overflow and underflow are rare, let the policy's strtod pick infinity or zero
+	if (std::from_chars(First, Last, Value).ec == std::errc::result_out_of_range)
 	{
-		return { TYPE_INT, NumberString, std::move(StartPosition), CurrentPosition };
+		Value = TPolicy::Parse(IsCopy ? Text.data() : CopyDigits(Text, Buffer, LongDigits).data());
 	}
 
-	return { TYPE_FLOAT, NumberString, std::move(StartPosition), CurrentPosition };
+	return BasicNumber<TPolicy>(Value);
 }
+
+template BasicNumber<LongDoublePolicy> Lexer::GetNumberValue<LongDoublePolicy>(std::string_view, ETokenType, int32_t);
+template BasicNumber<DoublePolicy> Lexer::GetNumberValue<DoublePolicy>(std::string_view, ETokenType, int32_t);
+template BasicNumber<FloatPolicy> Lexer::GetNumberValue<FloatPolicy>(std::string_view, ETokenType, int32_t);
@@ -3,19 +3,64 @@
 #include "Token.h"
 #include "Position.h"
 
+class ErrorManager;
+class EvaluationBudget;
+
+// Pull-based lexer. Tokens are produced one at a time and their values point into the borrowed input,
+// so the input has to outlive every token taken from it.
 class Lexer
 {
 public:
-	static std::vector<Token> GetTokens(std::string& Input);
-	static void Advance();
-
-	[[nodiscard]] static Token GetNumberToken();
-	[[nodiscard]] static auto GetInput() { return CurrentInput; }
-	[[nodiscard]] static auto GetCurrentPosition() { return CurrentPosition; }
-	[[nodiscard]] static auto GetCurrentCharacter() { return CurrentCharacter; }
-
-private:
-	static std::string* CurrentInput;
-	static Position CurrentPosition;
-	static char CurrentCharacter;
+	// Every token is charged to Budget when one is given, an exhausted budget ends the stream like an illegal character
+	Lexer(std::string_view Input, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+
+	// Lexes only Input[BeginIndex, EndIndex), positions and values stay relative to the whole input
+	Lexer(std::string_view Input, ErrorManager& Errors, int32_t BeginIndex, int32_t EndIndex, EvaluationBudget* Budget = nullptr);
+
+	// Lexes the whole input at once, returns an empty vector on an illegal character or an exhausted budget
+	static std::pmr::vector<Token> GetTokens(std::string_view Input,
+	                                         ErrorManager& Errors,
+	                                         EvaluationBudget* Budget = nullptr,
+	                                         std::pmr::memory_resource* Resource = std::pmr::get_default_resource());
+
+	// Returns the next token. Keeps returning TYPE_EOF at the end of the input or after an illegal character.
+	[[nodiscard]] Token GetNextToken();
+
+	// True once an illegal character or an exhausted budget has been reported
+	[[nodiscard]] bool HasFailed() const { return Failed; }
+
+	[[nodiscard]] auto GetInput() const { return Input; }
+	[[nodiscard]] auto GetCurrentPosition() const { return CurrentPosition; }
+	[[nodiscard]] auto GetCurrentCharacter() const { return CurrentCharacter; }
+
+	// Protected fields and functions
+protected:
+	void Advance();
+	[[nodiscard]] char PeekCharacter(int32_t Offset) const;
+
+	/*
+	 * Number literals:
+	 *
+	 *		123, 1_000_000       - TYPE_INT, saturates at INT64_MAX
+	 *		0x7f, 0xFFFF_FFFF    - TYPE_INT in hex
+	 *		1.5, 1., 2e10, 1e-9  - TYPE_FLOAT, a fraction or exponent makes a float
+	 *
+	 * '_' separates digits and is only allowed between two of them. A trailing 'e', '0x' or '_' that is not
+	 * followed by a digit is not part of the number and lexes as an illegal character.
+	 */
+	[[nodiscard]] Token GetNumberToken();
+	template <typename TPredicate>
+	void SkipDigits(TPredicate IsDigitCharacter);
+
+	// Correctly rounded value of a literal without its "0x" prefix, instantiated for every numeric policy
+	template <typename TPolicy>
+	[[nodiscard]] static BasicNumber<TPolicy> GetNumberValue(std::string_view Digits, ETokenType Type, int32_t Base);
+
+	std::string_view Input;
+	int32_t EndIndex;
+	ErrorManager& Errors;
+	EvaluationBudget* Budget;
+	Position CurrentPosition;
+	char CurrentCharacter;
+	bool Failed;
 };
@@ -0,0 +1,150 @@
+﻿#include "Pch.h"
+
+#include "ParallelLexer.h"
+#include "Lexer.h"
+#include "ErrorManager.h"
+
+namespace ParallelLexer
+{
+	struct Chunk
+	{
+		Chunk(const int32_t Begin, const int32_t End)
+			: Begin(Begin),
+			  End(End)
+		{
+		}
+
+		int32_t Begin;
+		int32_t End;
+		std::vector<Token> Tokens;
+		ErrorManager Errors;
+	};
+
+	// Digits, '.', '_' separators and the letters of hex literals and exponents. Through unsigned char, a negative
+	// char is undefined behaviour for isalnum.
+	static bool IsNumberCharacter(const char Character)
+	{
+		return isalnum(static_cast<unsigned char>(Character)) || Character == '.' || Character == '_';
+	}
+
+	static bool IsExponent(const char Character)
+	{
+		return Character == 'e' || Character == 'E';
+	}
+
+	// True when Input[Index - 1] and Input[Index] could belong to the same number, including around the sign of "1e-9"
+	static bool IsInsideNumber(const std::string_view Input, const size_t Index)
+	{
+		const char Previous = Input[Index - 1];
+		const char Current = Input[Index];
+
+		if (IsNumberCharacter(Previous) && IsNumberCharacter(Current))
+		{
+			return true;
+		}
+
+		if (Current == '+' || Current == '-')
+		{
+			return IsExponent(Previous);
+		}
+
+		return (Previous == '+' || Previous == '-') && Index >= 2 && IsExponent(Input[Index - 2]);
+	}
+
+	// Moves a cut forward until it is not inside a number
+	static size_t GetCut(const std::string_view Input, size_t Index)
+	{
+		while (Index < Input.size() && IsInsideNumber(Input, Index))
+		{
+			Index++;
+		}
+
+		return Index;
+	}
+
+	static void LexChunk(const std::string_view Input, Chunk& CurrentChunk)
+	{
+		Lexer Source(Input, CurrentChunk.Errors, CurrentChunk.Begin, CurrentChunk.End);
+
+		for (Token CurrentToken = Source.GetNextToken(); CurrentToken.Type != TYPE_EOF; CurrentToken = Source.GetNextToken())
+		{
+			CurrentChunk.Tokens.push_back(CurrentToken);
+		}
+	}
+
+	std::pmr::vector<Token> GetTokens(const std::string_view Input, ErrorManager& Errors, uint32_t ThreadCount, std::pmr::memory_resource* Resource, const size_t MinChunkSize)
+	{
+		if (ThreadCount == 0)
+		{
+			ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		if (Input.size() < MinChunkSize * 2 || ThreadCount == 1)
+		{
+			return Lexer::GetTokens(Input, Errors, nullptr, Resource);
+		}
+
+		// A few chunks per thread so a slow chunk does not hold up the others
+		const size_t ChunkCount = std::min<size_t>(ThreadCount * 4, Input.size() / MinChunkSize);
+		const size_t ChunkSize = Input.size() / ChunkCount;
+
+		std::vector<Chunk> Chunks;
+		size_t Begin = 0;
+
+		while (Begin < Input.size())
+		{
+			const size_t End = Chunks.size() + 1 == ChunkCount ? Input.size() : GetCut(Input, Begin + ChunkSize);
+			Chunks.emplace_back(static_cast<int32_t>(Begin), static_cast<int32_t>(End));
+			Begin = End;
+		}
+
+		std::atomic<size_t> NextChunk = 0;
+
+		const auto Worker = [&]()
+		{
+			for (size_t ChunkIndex = NextChunk++; ChunkIndex < Chunks.size(); ChunkIndex = NextChunk++)
+			{
+				LexChunk(Input, Chunks[ChunkIndex]);
+			}
+		};
+
+		std::vector<std::thread> Threads;
+
+		for (uint32_t ThreadIndex = 1; ThreadIndex < std::min<size_t>(ThreadCount, Chunks.size()); ++ThreadIndex)
+		{
+			Threads.emplace_back(Worker);
+		}
+
+		Worker();
+
+		for (std::thread& Thread : Threads)
+		{
+			Thread.join();
+		}
+
+		size_t TokenCount = 1;
+
+		for (const Chunk& CurrentChunk : Chunks)
+		{
+			// The serial lexer stops at the first illegal character, later chunks do not matter
+			if (const Error* FirstError = CurrentChunk.Errors.GetFirstError())
+			{
+				Errors.ReportError(FirstError->Code, FirstError->Start, FirstError->End, FirstError->Character);
+				return std::pmr::vector<Token>(Resource);
+			}
+
+			TokenCount += CurrentChunk.Tokens.size();
+		}
+
+		std::pmr::vector<Token> Result(Resource);
+		Result.reserve(TokenCount);
+
+		for (const Chunk& CurrentChunk : Chunks)
+		{
+			Result.insert(Result.end(), CurrentChunk.Tokens.begin(), CurrentChunk.Tokens.end());
+		}
+
+		Result.emplace_back(TYPE_EOF, std::string_view(), Position(static_cast<int32_t>(Input.size()), 0, static_cast<int32_t>(Input.size())));
+		return Result;
+	}
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include "Token.h"
+
+class ErrorManager;
+
+/*
+ * Lexer for multi-megabyte expressions. The input is cut into chunks at places where no token can straddle
+ * the cut (never between two characters of a number), worker threads lex the chunks into their own buffers
+ * and the buffers are concatenated in order. Tokens already carry offsets into the whole input.
+ *
+ * The result is the same as Lexer::GetTokens: on an illegal character only the first one is reported, with
+ * the same position, and an empty vector is returned. Columns equal offsets in every chunk because a line
+ * break is itself an illegal character.
+ */
+namespace ParallelLexer
+{
+	// Inputs shorter than two chunks are lexed on the calling thread
+	inline constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+	// ThreadCount 0 uses std::thread::hardware_concurrency(). Only the result is allocated from Resource, the
+	// per-chunk buffers of the worker threads use the default resource because Resource need not be thread-safe.
+	// Fuzz targets lower MinChunkSize to get cuts in short inputs.
+	std::pmr::vector<Token> GetTokens(std::string_view Input,
+	                                  ErrorManager& Errors,
+	                                  uint32_t ThreadCount = 0,
+	                                  std::pmr::memory_resource* Resource = std::pmr::get_default_resource(),
+	                                  size_t MinChunkSize = MIN_CHUNK_SIZE);
+}
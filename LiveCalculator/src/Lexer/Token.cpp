@@ -3,9 +3,10 @@
 
 #include "Token.h"
 
-Token::Token(const ETokenType Type, std::string Value, Position StartPos, Position EndPos)
+Token::Token(const ETokenType Type, const std::string_view Value, Position StartPos, Position EndPos, const Number Literal)
 	: Type(Type),
-	  Value(std::move(Value)),
+	  Value(Value),
+	  Literal(Literal),
 	  Start(std::move(StartPos)),
 	  End(std::move(EndPos))
 {
@@ -20,7 +21,7 @@ std::string Token::GetPrintableTokenString() const
 {
 	if (!Value.empty())
 	{
-		return std::format("[{}:{}]", GTokenTypeNames[Type], Value.c_str());
+		return std::format("[{}:{}]", GTokenTypeNames[Type], Value);
 	}
 
 	return std::format("[{}]", GTokenTypeNames[Type]);
@@ -3,8 +3,9 @@
 
 #include "Position.h"
 #include "Printable.h"
+#include "../Interpreter/Number.h"
 
-enum ETokenType
+enum ETokenType : uint8_t
 {
 	TYPE_INT,
 	TYPE_FLOAT,
@@ -35,12 +36,17 @@ class Token final : public Printable
 public:
 	Token() = delete;
 
-	Token(ETokenType Type, std::string Value = "", Position StartPos = { -1, 0, 0, "" }, Position EndPos = { -1, 0, 0, "" });
+	Token(ETokenType Type, std::string_view Value = {}, Position StartPos = { -1, 0, 0 }, Position EndPos = { -1, 0, 0 }, Number Literal = {});
 	[[nodiscard]] std::string GetPrintableTokenString() const;
 	void Print() override;
 
 	ETokenType Type;
-	std::string Value;
+
+	// Points into the lexer input, empty for operators
+	std::string_view Value;
+
+	// Value of a TYPE_INT or TYPE_FLOAT token, parsed once by the lexer
+	Number Literal;
 	Position Start;
 	Position End;
 };
@@ -0,0 +1,43 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "AstPrinter.h"
+
+namespace AstPrinter
+{
+	[[nodiscard]] std::string GetPrintableString(const SyntaxTree& Tree, const uint32_t NodeIndex)
+	{
+		const SyntaxNode& Node = Tree.GetNode(NodeIndex);
+
+		switch (Node.Type)
+		{
+		case NODE_TYPE_NUMBER:
+		{
+			const Number& Value = Tree.GetLiteral(Node);
+
+			if (Value.IsInt)
+			{
+				return std::format("[{}:{}]", GTokenTypeNames[Node.Operator], Value.IntValue);
+			}
+
+			return std::format("[{}:{}]", GTokenTypeNames[Node.Operator], Value.FloatValue);
+		}
+
+		case NODE_TYPE_BINARY_OP:
+			return std::format("({}, [{}], {})", GetPrintableString(Tree, Node.Left), GTokenTypeNames[Node.Operator], GetPrintableString(Tree, Node.Right));
+
+		case NODE_TYPE_UNARY_OP:
+			return std::format("([{}], {})", GTokenTypeNames[Node.Operator], GetPrintableString(Tree, Node.Left));
+
+		case NODE_TYPE_ERROR:
+			break;
+		}
+
+		return "[ERROR]";
+	}
+
+	void Print(const SyntaxTree& Tree, const uint32_t NodeIndex)
+	{
+		printf("%s", GetPrintableString(Tree, NodeIndex).c_str());
+	}
+}
@@ -0,0 +1,10 @@
+﻿#pragma once
+
+#include "NodeTypes.h"
+
+// Debug printing of syntax trees, kept out of the nodes so they stay plain data
+namespace AstPrinter
+{
+	[[nodiscard]] std::string GetPrintableString(const SyntaxTree& Tree, uint32_t NodeIndex);
+	void Print(const SyntaxTree& Tree, uint32_t NodeIndex);
+}
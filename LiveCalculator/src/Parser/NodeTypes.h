@@ -1,184 +1,129 @@
 ﻿#pragma once
 
 #include "../Lexer/Token.h"
+#include "../Interpreter/Number.h"
 
-enum ENodeType
+enum ENodeType : uint8_t
 {
 	NODE_TYPE_NUMBER,
 	NODE_TYPE_BINARY_OP,
-	NODE_TYPE_UNARY_OP
+	NODE_TYPE_UNARY_OP,
+	NODE_TYPE_ERROR // Placeholder inserted by the parser where an operand could not be parsed
 };
 
-class NodeBase : public Printable
+inline constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+/*
+ * One syntax tree node. Nodes live contiguously in a SyntaxTree and refer to each other by index, children
+ * are always created before their parent.
+ *
+ *		NODE_TYPE_NUMBER    - Left is the index into SyntaxTree::Literals, Operator is TYPE_INT or TYPE_FLOAT
+ *		NODE_TYPE_BINARY_OP - Left and Right are the operand nodes
+ *		NODE_TYPE_UNARY_OP  - Left is the operand node
+ *		NODE_TYPE_ERROR     - no children
+ */
+struct SyntaxNode
 {
-public:
-	explicit NodeBase(const ENodeType InType, Position StartPosition, Position EndPosition)
-		: Type(InType),
-		  Start(std::move(StartPosition)),
-		  End(std::move(EndPosition))
-	{
-	}
-
-	[[nodiscard]] virtual bool IsValid() const = 0;
-	[[nodiscard]] virtual std::string GetPrintableTokenString() const = 0;
-
 	ENodeType Type;
-	Position Start;
-	Position End;
+	ETokenType Operator;
+	uint32_t Left;
+	uint32_t Right;
+
+	// Source span as character offsets
+	int32_t Start;
+	int32_t End;
 };
 
-class NumberNode final : public NodeBase
+static_assert(std::is_trivially_copyable_v<SyntaxNode>);
+static_assert(sizeof(SyntaxNode) == 20);
+
+// Read-only nodes and literals stored elsewhere, in a SyntaxTree or a mapped ExpressionCache file
+class SyntaxTreeView
 {
 public:
-	explicit NumberNode(Token* InToken)
-		: NodeBase(NODE_TYPE_NUMBER, InToken->Start, InToken->End),
-		  Token(InToken)
+	SyntaxTreeView(const std::span<const SyntaxNode> Nodes, const std::span<const Number> Literals)
+		: Nodes(Nodes),
+		  Literals(Literals)
 	{
-		IsInt = InToken->Type == TYPE_INT ? true : false;
 	}
 
-	[[nodiscard]] bool IsValid() const override
+	[[nodiscard]] const SyntaxNode& GetNode(const uint32_t Index) const
 	{
-		return Token != nullptr;
-	}
-
-	[[nodiscard]] std::string GetPrintableTokenString() const override
-	{
-		if (Token == nullptr)
-		{
-			return {};
-		}
-
-		return Token->GetPrintableTokenString();
+		return Nodes[Index];
 	}
 
-	void Print() override
+	[[nodiscard]] const Number& GetLiteral(const SyntaxNode& Node) const
 	{
-		printf("%s", GetPrintableTokenString().c_str());
+		return Literals[Node.Left];
 	}
 
-	[[nodiscard]] Token* GetToken() const
+	// First node of the contiguous range of a subtree, reached by following left children
+	[[nodiscard]] uint32_t GetFirstNode(uint32_t Index) const
 	{
-		return Token;
-	}
-
-	[[nodiscard]] std::string& GetValue() const
-	{
-		return Token->Value;
-	}
-
-	[[nodiscard]] int64_t GetIntValue() const
-	{
-		return std::strtoll(GetValue().c_str(), nullptr, 10);
-	}
+		while (Nodes[Index].Type == NODE_TYPE_BINARY_OP || Nodes[Index].Type == NODE_TYPE_UNARY_OP)
+		{
+			Index = Nodes[Index].Left;
+		}
 
-	[[nodiscard]] long double GetLongDoubleValue() const
-	{
-		return std::strtold(GetValue().c_str(), nullptr);
+		return Index;
 	}
 
-	bool IsInt;
-
-	// Protected fields and functions
-protected:
-	Token* Token;
+	std::span<const SyntaxNode> Nodes;
+	std::span<const Number> Literals;
 };
 
-class BinaryOpNode final : public NodeBase
+// Node pool of one or more parsed expressions
+class SyntaxTree
 {
 public:
-	explicit BinaryOpNode(Token* Token, NodeBase* Left, NodeBase* Right)
-		: NodeBase(NODE_TYPE_BINARY_OP, Left->Start, Right->End),
-		  Token(Token),
-		  LeftNode(Left),
-		  RightNode(Right)
+	SyntaxTree() = default;
+
+	explicit SyntaxTree(std::pmr::memory_resource* Resource)
+		: Nodes(Resource),
+		  Literals(Resource)
 	{
 	}
 
-	[[nodiscard]] bool IsValid() const override
+	operator SyntaxTreeView() const
 	{
-		if (Token != nullptr &&
-			LeftNode->IsValid() &&
-			RightNode->IsValid())
-		{
-			return true;
-		}
-
-		return false;
+		return { Nodes, Literals };
 	}
 
-	[[nodiscard]] std::string GetPrintableTokenString() const override
+	uint32_t AddNode(const SyntaxNode& Node)
 	{
-		std::string LeftTokenString;
-		std::string MyTokenString;
-		std::string RightTokenString;
-
-		if (LeftNode)
-		{
-			LeftTokenString = LeftNode->GetPrintableTokenString();
-		}
-
-		if (Token)
-		{
-			MyTokenString = Token->GetPrintableTokenString();
-		}
-
-		if (RightNode)
-		{
-			RightTokenString = RightNode->GetPrintableTokenString();
-		}
-
-		return std::format("({}, {}, {})", LeftTokenString, MyTokenString, RightTokenString);
+		Nodes.push_back(Node);
+		return static_cast<uint32_t>(Nodes.size() - 1);
 	}
 
-	void Print() override
+	uint32_t AddLiteral(const Number& Value)
 	{
-		printf("%s", GetPrintableTokenString().c_str());
+		Literals.push_back(Value);
+		return static_cast<uint32_t>(Literals.size() - 1);
 	}
 
-	Token* Token;
-	NodeBase* LeftNode;
-	NodeBase* RightNode;
-};
-
-class UnaryOpNode final : public NodeBase
-{
-public:
-	explicit UnaryOpNode(Token* OperatorToken, NodeBase* Node)
-		: NodeBase(NODE_TYPE_UNARY_OP, OperatorToken->Start, Node->End),
-		  OperatorToken(OperatorToken),
-		  ChildNode(Node)
+	[[nodiscard]] const SyntaxNode& GetNode(const uint32_t Index) const
 	{
+		return Nodes[Index];
 	}
 
-	[[nodiscard]] bool IsValid() const override
+	[[nodiscard]] const Number& GetLiteral(const SyntaxNode& Node) const
 	{
-		return OperatorToken != nullptr && ChildNode != nullptr;
+		return Literals[Node.Left];
 	}
 
-	[[nodiscard]] std::string GetPrintableTokenString() const override
+	void Reserve(const size_t NodeCount, const size_t LiteralCount)
 	{
-		std::string Token;
-		std::string NodeString;
-
-		if (OperatorToken)
-		{
-			Token = OperatorToken->GetPrintableTokenString();
-		}
-
-		if (ChildNode)
-		{
-			NodeString = ChildNode->GetPrintableTokenString();
-		}
-
-		return std::format("({}, {})", Token.c_str(), NodeString.c_str());
+		Nodes.reserve(NodeCount);
+		Literals.reserve(LiteralCount);
 	}
 
-	void Print() override
+	// Keeps the storage for reuse
+	void Clear()
 	{
-		printf("%s", GetPrintableTokenString().c_str());
+		Nodes.clear();
+		Literals.clear();
 	}
 
-	Token* OperatorToken;
-	NodeBase* ChildNode;
+	std::pmr::vector<SyntaxNode> Nodes;
+	std::pmr::vector<Number> Literals;
 };
@@ -3,6 +3,9 @@
 
 #include "Parser.h"
 #include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Trace.h"
+#include "Lexer/Lexer.h"
 
 /*
  * expr: term ((PLUS | MINUS) term)*
@@ -10,155 +13,296 @@
  * factor: INT | FLOAT
  *		   (PLUS|MINUS) factor
  *		   LBRACKET expr RBRACKET
+ *
+ * Syntax errors do not stop the parser. A missing operand is replaced by an error node without consuming
+ * the offending token, a missing ')' skips ahead to the matching bracket and a ')' without its '(' is skipped.
+ * Every error is reported once and the returned tree can still be evaluated for a partial result.
  */
 
-std::vector<Token> Parser::Tokens;
-std::vector<std::unique_ptr<NodeBase>> Parser::Nodes;
-Token* Parser::CurrentToken;
-int32_t Parser::TokenIndex;
+Parser::Parser(const std::span<const Token> InTokens, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget)
+	: Tokens(InTokens),
+	  Source(nullptr),
+	  Tree(OutTree),
+	  Errors(Errors),
+	  Budget(Budget),
+	  CurrentToken(TYPE_EOF, {}, Position(0, 0, 0)),
+	  TokenIndex(0),
+	  Depth(0)
+{
+}
 
-NodeBase* Parser::GetExpressionResult(const std::vector<Token>& InTokens)
+Parser::Parser(Lexer& Source, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget)
+	: Source(&Source),
+	  Tree(OutTree),
+	  Errors(Errors),
+	  Budget(Budget),
+	  CurrentToken(TYPE_EOF, {}, Position(0, 0, 0)),
+	  TokenIndex(0),
+	  Depth(0)
 {
-	ErrorManager::Clear();
+}
 
-	Tokens = InTokens;
-	CurrentToken = nullptr;
-	TokenIndex = -1;
+uint32_t Parser::GetExpressionResult(const std::span<const Token> InTokens, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget)
+{
+	WL_TRACE_SCOPE("Parse", InTokens.size());
+	return Parser(InTokens, OutTree, Errors, Budget).Parse();
+}
 
-	Advance();
+uint32_t Parser::GetExpressionResult(const std::string_view Input, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget)
+{
+	WL_TRACE_SCOPE("LexAndParse", Input.size());
 
-	NodeBase* Result = GetExpression();
+	Lexer Source(Input, Errors, Budget);
+	return Parser(Source, OutTree, Errors, Budget).Parse();
+}
+
+uint32_t Parser::Parse()
+{
+	TokenIndex = 0;
 
-	// Checks for errors from parsing
-	if (!ErrorManager::CheckLastError())
+	if (Source != nullptr)
+	{
+		CurrentToken = Source->GetNextToken();
+	}
+	else if (!Tokens.empty())
 	{
-		return Result;
+		CurrentToken = Tokens.front();
 	}
-	 
+
+	const size_t FirstError = Errors.GetErrors().size();
+	uint32_t Result = GetExpression();
+
 	// Check that we actually reached end of the file/string
-	// Otherwise there was an error at some point
-	if (CurrentToken->Type != TYPE_EOF)
+	// Otherwise there was an error at some point. A ')' without its '(' is skipped after its error and the
+	// expression carries on behind it, so "1 ) + 2" still adds the 2.
+	while (CurrentToken.Type != TYPE_EOF)
 	{
-		ErrorManager::SetLastError(Error("Invalid Syntax", "Expected operator ('+', '-', '*', '/')", CurrentToken->Start, CurrentToken->End));
-		return Result;
+		// "1 + )" already reported the missing number at the bracket
+		const std::pmr::vector<Error>& Reported = Errors.GetErrors();
+
+		if (Reported.size() == FirstError || Reported.back().Start != CurrentToken.Start.Index)
+		{
+			ReportError(ERROR_EXPECTED_OPERATOR, CurrentToken);
+		}
+
+		if (CurrentToken.Type != TYPE_RBRACKET)
+		{
+			break;
+		}
+
+		Advance();
+		Result = ContinueExpression(ContinueTerm(Result));
 	}
 
 	return Result;
 }
 
-Token* Parser::Advance()
+void Parser::Advance()
 {
-	TokenIndex++;
+	// Stop where the budget ran out, the rest of the input is treated as missing
+	if (Budget != nullptr && Budget->IsExhausted())
+	{
+		CurrentToken = Token(TYPE_EOF, {}, CurrentToken.End);
+	}
+	else if (Source != nullptr)
+	{
+		CurrentToken = Source->GetNextToken();
+	}
+	else if (TokenIndex + 1 < Tokens.size())
+	{
+		// Stays on the last token (EOF) once the span is exhausted
+		CurrentToken = Tokens[++TokenIndex];
+	}
+}
 
-	if (TokenIndex < static_cast<int32_t>(Tokens.size()))
+void Parser::SkipToClosingBracket()
+{
+	int32_t BracketDepth = 0;
+
+	while (CurrentToken.Type != TYPE_EOF)
 	{
-		CurrentToken = &Tokens.at(TokenIndex);
+		if (CurrentToken.Type == TYPE_LBRACKET)
+		{
+			BracketDepth++;
+		}
+		else if (CurrentToken.Type == TYPE_RBRACKET)
+		{
+			if (BracketDepth == 0)
+			{
+				Advance();
+				return;
+			}
+
+			BracketDepth--;
+		}
+
+		Advance();
 	}
+}
 
-	return CurrentToken;
+void Parser::ReportError(const EErrorCode Code, const Token& OffendingToken) const
+{
+	// After an illegal character or an exhausted budget the stream ends early, syntax errors from there on are only a consequence of that
+	if ((Source != nullptr && Source->HasFailed()) || (Budget != nullptr && Budget->IsExhausted()))
+	{
+		return;
+	}
+
+	Errors.ReportError(Code, OffendingToken.Start.Index, OffendingToken.End.Index);
 }
 
-[[nodiscard]] NodeBase* Parser::GetFactor()
+// Counts one more level of nesting, false when that goes past the depth limit
+[[nodiscard]] bool Parser::EnterNesting(const Token& NestingToken)
 {
-	Token* SavedToken = CurrentToken;
+	Depth++;
+	return Budget == nullptr || Budget->CheckDepth(Depth, Errors, NestingToken.Start.Index, NestingToken.End.Index);
+}
 
-	if (SavedToken->Type == TYPE_PLUS || SavedToken->Type == TYPE_MINUS)
+[[nodiscard]] uint32_t Parser::GetFactor()
+{
+	const Token SavedToken = CurrentToken;
+
+	if (SavedToken.Type == TYPE_PLUS || SavedToken.Type == TYPE_MINUS)
 	{
 		Advance();
-		NodeBase* Factor = GetFactor();
 
-		if (!ErrorManager::CheckLastError())
+		if (!EnterNesting(SavedToken))
+		{
+			Depth--;
+			return CreateErrorNode(SavedToken);
+		}
+
+		const uint32_t Factor = GetFactor();
+		Depth--;
+
+		// A missing operand absorbs the sign
+		if (Tree.GetNode(Factor).Type == NODE_TYPE_ERROR)
 		{
-			return nullptr;
+			return Factor;
 		}
 
-		return CreateNode<UnaryOpNode>(SavedToken, Factor);
+		return CreateUnaryNode(SavedToken, Factor);
 	}
 
-	if (SavedToken->Type == TYPE_INT || SavedToken->Type == TYPE_FLOAT)
+	if (SavedToken.Type == TYPE_INT || SavedToken.Type == TYPE_FLOAT)
 	{
 		Advance();
-		return CreateNode<NumberNode>(SavedToken);
+		return CreateNumberNode(SavedToken);
 	}
 
-	if (SavedToken->Type == TYPE_LBRACKET)
+	if (SavedToken.Type == TYPE_LBRACKET)
 	{
 		Advance();
-		NodeBase* Expression = GetExpression();
 
-		if (!ErrorManager::CheckLastError())
+		if (!EnterNesting(SavedToken))
 		{
-			return nullptr;
+			Depth--;
+			return CreateErrorNode(SavedToken);
 		}
 
-		if (CurrentToken->Type == TYPE_RBRACKET)
+		const uint32_t Expression = GetExpression();
+		Depth--;
+
+		if (CurrentToken.Type == TYPE_RBRACKET)
 		{
 			Advance();
 			return Expression;
 		}
 
-		ErrorManager::SetLastError(Error("Invalid Syntax", "Expected ')'", CurrentToken->Start, CurrentToken->End));
+		ReportError(ERROR_EXPECTED_RBRACKET, CurrentToken);
+		SkipToClosingBracket();
 
-		return nullptr;
+		return Expression;
 	}
 
-	ErrorManager::SetLastError(Error("Invalid Syntax", "Expected integer or floating-point number", SavedToken->Start, SavedToken->End));
+	ReportError(ERROR_EXPECTED_NUMBER, SavedToken);
 
-	return nullptr;
+	// Leave the token in place so the caller can continue from it
+	return CreateErrorNode(SavedToken);
 }
 
-[[nodiscard]] NodeBase* Parser::GetTerm()
+[[nodiscard]] uint32_t Parser::GetTerm()
 {
-	NodeBase* LeftToken = GetFactor();
+	return ContinueTerm(GetFactor());
+}
 
-	if (!ErrorManager::CheckLastError())
+[[nodiscard]] uint32_t Parser::ContinueTerm(uint32_t LeftNode)
+{
+	while (CurrentToken.Type == TYPE_MUL || CurrentToken.Type == TYPE_DIV)
 	{
-		return nullptr;
+		const Token OperatorToken = CurrentToken;
+
+		Advance();
+
+		const uint32_t RightNode = GetFactor();
+
+		LeftNode = CreateBinaryNode(OperatorToken, LeftNode, RightNode);
 	}
 
-	while (CurrentToken->Type == TYPE_MUL || CurrentToken->Type == TYPE_DIV)
+	return LeftNode;
+}
+
+[[nodiscard]] uint32_t Parser::GetExpression()
+{
+	return ContinueExpression(GetTerm());
+}
+
+[[nodiscard]] uint32_t Parser::ContinueExpression(uint32_t LeftNode)
+{
+	while (CurrentToken.Type == TYPE_PLUS || CurrentToken.Type == TYPE_MINUS)
 	{
-		Token* OperatorToken = CurrentToken;
+		const Token OperatorToken = CurrentToken;
 
 		Advance();
 
-		const auto RightToken = GetFactor();
+		const uint32_t RightNode = GetTerm();
 
-		if (!ErrorManager::CheckLastError())
-		{
-			return nullptr;
-		}
-
-		LeftToken = static_cast<NodeBase*>(CreateNode<BinaryOpNode>(OperatorToken, LeftToken, RightToken));
+		LeftNode = CreateBinaryNode(OperatorToken, LeftNode, RightNode);
 	}
 
-	return LeftToken;
+	return LeftNode;
 }
 
-[[nodiscard]] NodeBase* Parser::GetExpression()
+[[nodiscard]] uint32_t Parser::CreateNumberNode(const Token& NumberToken)
 {
-	auto LeftToken = GetTerm();
-
-	if (!ErrorManager::CheckLastError())
+	if (Budget != nullptr)
 	{
-		return nullptr;
+		(void)Budget->AddNode(Errors, NumberToken.Start.Index, NumberToken.End.Index);
 	}
 
-	while (CurrentToken->Type == TYPE_PLUS || CurrentToken->Type == TYPE_MINUS)
+	const uint32_t Literal = Tree.AddLiteral(NumberToken.Literal);
+	return Tree.AddNode({ NODE_TYPE_NUMBER, NumberToken.Type, Literal, INVALID_NODE, NumberToken.Start.Index, NumberToken.End.Index });
+}
+
+[[nodiscard]] uint32_t Parser::CreateUnaryNode(const Token& OperatorToken, const uint32_t Child)
+{
+	if (Budget != nullptr)
 	{
-		Token* OperatorToken = CurrentToken;
+		(void)Budget->AddNode(Errors, OperatorToken.Start.Index, OperatorToken.End.Index);
+	}
 
-		Advance();
+	return Tree.AddNode({ NODE_TYPE_UNARY_OP, OperatorToken.Type, Child, INVALID_NODE, OperatorToken.Start.Index, Tree.GetNode(Child).End });
+}
 
-		const auto RightToken = GetTerm();
+[[nodiscard]] uint32_t Parser::CreateErrorNode(const Token& OffendingToken)
+{
+	return Tree.AddNode({ NODE_TYPE_ERROR, OffendingToken.Type, INVALID_NODE, INVALID_NODE, OffendingToken.Start.Index, OffendingToken.End.Index });
+}
 
-		if (!ErrorManager::CheckLastError())
-		{
-			return nullptr;
-		}
+[[nodiscard]] uint32_t Parser::CreateBinaryNode(const Token& OperatorToken, const uint32_t Left, const uint32_t Right)
+{
+	const SyntaxNode& LeftNode = Tree.GetNode(Left);
+	const SyntaxNode& RightNode = Tree.GetNode(Right);
 
-		LeftToken = static_cast<NodeBase*>(CreateNode<BinaryOpNode>(OperatorToken, LeftToken, RightToken));
+	if (LeftNode.Type == NODE_TYPE_ERROR && RightNode.Type == NODE_TYPE_ERROR)
+	{
+		return Left;
+	}
+
+	if (Budget != nullptr)
+	{
+		(void)Budget->AddNode(Errors, OperatorToken.Start.Index, OperatorToken.End.Index);
 	}
 
-	return LeftToken;
+	return Tree.AddNode({ NODE_TYPE_BINARY_OP, OperatorToken.Type, Left, Right, LeftNode.Start, RightNode.End });
 }
@@ -1,40 +1,61 @@
 ﻿#pragma once
 
 #include "NodeTypes.h"
+#include "../ErrorManager.h"
 
+class EvaluationBudget;
+class Lexer;
+
+// Recursive descent parser. Tokens are either borrowed from a span or pulled from a lexer while parsing,
+// neither way copies them.
 class Parser
 {
 public:
-	static NodeBase* GetExpressionResult(const std::vector<Token>& InTokens);
-	static Token* Advance();
-	[[nodiscard]] static NodeBase* GetFactor();
-	[[nodiscard]] static NodeBase* GetTerm();
-	[[nodiscard]] static NodeBase* GetExpression();
-
-	template <class NodeTy, class... Args>
-	[[nodiscard]] static NodeTy* CreateNode(Args... NodeArgs)
-	{
-		// Create new node
-		Nodes.emplace_back(std::make_unique<NodeTy>(NodeArgs...));
-
-		// Get raw ptr to node and return
-		return static_cast<NodeTy*>(Nodes.back().get());
-	}
-
-	template <class NodeTy, class RetTy, class... Args>
-	[[nodiscard]] static RetTy* CreateNode(Args... NodeArgs)
-	{
-		// Create new node
-		Nodes.emplace_back(std::make_unique<NodeTy>(NodeArgs...));
-
-		// Get raw ptr to node and return
-		return static_cast<RetTy*>(Nodes.back().get());
-	}
+	// With a budget every node counts towards its node limit and nesting is checked against its depth limit,
+	// an exhausted budget ends the token stream
+	Parser(std::span<const Token> InTokens, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+	Parser(Lexer& Source, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+
+	// Appends the parsed expression to OutTree and returns the index of its root node
+	uint32_t Parse();
+
+	// Parses already lexed tokens
+	static uint32_t GetExpressionResult(std::span<const Token> InTokens, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
+
+	// Lexes and parses Input in a single pass
+	static uint32_t GetExpressionResult(std::string_view Input, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget* Budget = nullptr);
 
 	// Protected fields and functions
 protected:
-	static std::vector<Token> Tokens;
-	static std::vector<std::unique_ptr<NodeBase>> Nodes;
-	static Token* CurrentToken;
-	static int32_t TokenIndex;
+	void Advance();
+	void SkipToClosingBracket();
+	void ReportError(EErrorCode Code, const Token& OffendingToken) const;
+	[[nodiscard]] bool EnterNesting(const Token& NestingToken);
+	[[nodiscard]] uint32_t GetFactor();
+	[[nodiscard]] uint32_t GetTerm();
+	[[nodiscard]] uint32_t GetExpression();
+
+	// Apply the operators that follow to an already parsed left operand
+	[[nodiscard]] uint32_t ContinueTerm(uint32_t LeftNode);
+	[[nodiscard]] uint32_t ContinueExpression(uint32_t LeftNode);
+
+	[[nodiscard]] uint32_t CreateNumberNode(const Token& NumberToken);
+	[[nodiscard]] uint32_t CreateUnaryNode(const Token& OperatorToken, uint32_t Child);
+	[[nodiscard]] uint32_t CreateErrorNode(const Token& OffendingToken);
+
+	// Creates a binary node, two missing operands collapse into a single error node
+	[[nodiscard]] uint32_t CreateBinaryNode(const Token& OperatorToken, uint32_t Left, uint32_t Right);
+
+	// Exactly one of Tokens and Source is used
+	std::span<const Token> Tokens;
+	Lexer* Source;
+
+	SyntaxTree& Tree;
+	ErrorManager& Errors;
+	EvaluationBudget* Budget;
+	Token CurrentToken;
+	size_t TokenIndex;
+
+	// Brackets and signs the parser is currently inside of
+	uint32_t Depth;
 };
@@ -2,12 +2,33 @@
 
 // STL
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <vector>
+
+// std::format is C++20 but only shipped with GCC 13, Clang 17 and Visual Studio 2022
+#if !__has_include(<format>)
+#error "<format> is missing, LiveCalculator needs GCC 13, Clang 17 or Visual Studio 2022 or newer"
+#endif
 #include <format>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <span>
+#include <array>
+#include <type_traits>
+#include <charconv>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <bit>
+#include <numeric>
+#include <optional>
+#include <memory>
+#include <memory_resource>
 
+// The UI is Windows only, the core sources also build on other platforms (see EvalServer)
+#ifdef _WIN32
 // Windows
 #define NOMINMAX
 #include <Windows.h>
@@ -26,3 +47,4 @@
 #include <misc/cpp/imgui_stdlib.h>
 #include <backends/imgui_impl_win32.h>
 #include <backends/imgui_impl_dx12.h>
+#endif
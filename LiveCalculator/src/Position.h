@@ -3,11 +3,10 @@
 class Position
 {
 public:
-	Position(const int32_t Index, const int32_t LineNumber, const int32_t ColumnNumber, std::string Input)
+	Position(const int32_t Index, const int32_t LineNumber, const int32_t ColumnNumber)
 		: Index(Index),
 		  LineNumber(LineNumber),
-		  ColumnNumber(ColumnNumber),
-		  Input(std::move(Input))
+		  ColumnNumber(ColumnNumber)
 	{
 	}
 
@@ -28,5 +27,4 @@ public:
 	int32_t Index;
 	int32_t LineNumber;
 	int32_t ColumnNumber;
-	std::string Input;
 };
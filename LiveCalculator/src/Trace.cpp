@@ -0,0 +1,137 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Trace.h"
+
+#ifdef WL_ENABLE_TRACING
+
+#include <cmath>
+#include <mutex>
+#include <utility>
+
+namespace Trace
+{
+	// Written by its own thread only. Count is published after the event, a reader copies the events and then
+	// drops the ones Count has moved past in the meantime.
+	struct ThreadBuffer
+	{
+		std::atomic<uint64_t> Count = 0;
+		uint32_t ThreadId = 0;
+		Event Events[RING_CAPACITY];
+	};
+
+	// Buffers are kept after their thread exits so its events can still be dumped
+	static std::mutex GBufferMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> GBuffers;
+
+	// Reference point for converting ticks, timestamps in the dump are relative to it
+	static const int64_t GEpochTicks = GetTicks();
+	static const std::chrono::steady_clock::time_point GEpochTime = std::chrono::steady_clock::now();
+
+	static thread_local ThreadBuffer* GThreadBuffer = nullptr;
+	static thread_local uint64_t GExpressionId = 0;
+
+	static ThreadBuffer& RegisterThread()
+	{
+		std::lock_guard Lock(GBufferMutex);
+
+		ThreadBuffer& Buffer = *GBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+		Buffer.ThreadId = static_cast<uint32_t>(GBuffers.size());
+
+		GThreadBuffer = &Buffer;
+		return Buffer;
+	}
+
+	void Record(const char* Name, const int64_t Start, const int64_t End, const uint64_t InputSize)
+	{
+		ThreadBuffer& Buffer = GThreadBuffer != nullptr ? *GThreadBuffer : RegisterThread();
+		const uint64_t Count = Buffer.Count.load(std::memory_order_relaxed);
+
+		Buffer.Events[Count % RING_CAPACITY] = { Name, Start, End - Start, GExpressionId, InputSize };
+		Buffer.Count.store(Count + 1, std::memory_order_release);
+	}
+
+	uint64_t SetExpression(const uint64_t ExpressionId)
+	{
+		return std::exchange(GExpressionId, ExpressionId);
+	}
+
+	static void AppendEvents(std::string& OutText, const ThreadBuffer& Buffer, const double NanosecondsPerTick, std::vector<Event>& Events, bool& IsFirst)
+	{
+		const uint64_t End = Buffer.Count.load(std::memory_order_acquire);
+		const uint64_t Begin = End > RING_CAPACITY ? End - RING_CAPACITY : 0;
+
+		Events.clear();
+
+		for (uint64_t Index = Begin; Index < End; ++Index)
+		{
+			Events.push_back(Buffer.Events[Index % RING_CAPACITY]);
+		}
+
+		// Slots the thread wrote again while they were copied hold newer events than their index says
+		const uint64_t Overwritten = Buffer.Count.load(std::memory_order_acquire);
+		const uint64_t FirstValid = std::max(Begin, Overwritten >= RING_CAPACITY ? Overwritten - RING_CAPACITY + 1 : 0);
+
+		for (uint64_t Index = FirstValid; Index < End; ++Index)
+		{
+			const Event& Current = Events[Index - Begin];
+			const int64_t Start = std::max<int64_t>(std::llround(static_cast<double>(Current.Start - GEpochTicks) * NanosecondsPerTick), 0);
+			const int64_t Duration = std::llround(static_cast<double>(Current.Duration) * NanosecondsPerTick);
+
+			OutText += std::format("{}\n\t{{ \"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {}.{:03}, \"dur\": {}.{:03}, "
+			                       "\"args\": {{ \"expression\": {}, \"input_size\": {} }} }}",
+			                       IsFirst ? "" : ",",
+			                       Current.Name,
+			                       Buffer.ThreadId,
+			                       Start / 1000, Start % 1000,
+			                       Duration / 1000, Duration % 1000,
+			                       Current.ExpressionId,
+			                       Current.InputSize);
+
+			IsFirst = false;
+		}
+	}
+
+	void AppendJson(std::string& OutText)
+	{
+		std::lock_guard Lock(GBufferMutex);
+
+		// The tick rate is measured over the whole run, that is exact for steady_clock and invariant counters
+		const int64_t ElapsedTicks = GetTicks() - GEpochTicks;
+		const int64_t ElapsedNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - GEpochTime).count();
+		const double NanosecondsPerTick = ElapsedTicks > 0 ? static_cast<double>(ElapsedNanoseconds) / static_cast<double>(ElapsedTicks) : 1.0;
+
+		std::vector<Event> Events;
+		bool IsFirst = true;
+
+		OutText += "{ \"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+		for (const std::unique_ptr<ThreadBuffer>& Buffer : GBuffers)
+		{
+			AppendEvents(OutText, *Buffer, NanosecondsPerTick, Events, IsFirst);
+		}
+
+		OutText += "\n] }\n";
+	}
+
+	bool WriteJson(const char* Path)
+	{
+		std::string Text;
+		AppendJson(Text);
+
+		FILE* File = std::fopen(Path, "wb");
+
+		if (File == nullptr)
+		{
+			printf("Could not open %s for writing\n", Path);
+			return false;
+		}
+
+		const bool Written = std::fwrite(Text.data(), 1, Text.size(), File) == Text.size();
+		std::fclose(File);
+
+		return Written;
+	}
+}
+
+#endif
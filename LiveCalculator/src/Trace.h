@@ -0,0 +1,120 @@
+﻿#pragma once
+
+/*
+ * Chrome trace events for the evaluation pipeline, compiled in with "premake5 --tracing" (WL_ENABLE_TRACING).
+ * Without it the macros expand to nothing and their arguments are not evaluated.
+ *
+ *		WL_TRACE_EXPRESSION(RequestId);               // events on this thread belong to RequestId until the scope ends
+ *		WL_TRACE_SCOPE("Parse", Input.size());        // one complete event covering the rest of the scope
+ *
+ * Every thread records into its own ring buffer of RING_CAPACITY events, so recording takes no lock and only
+ * the oldest events are lost when a thread records faster than the buffer is dumped. AppendJson() writes the
+ * buffers of every thread that ever recorded, in the JSON format chrome://tracing and ui.perfetto.dev load.
+ * A buffer lives as long as the process, so only long-lived threads (the UI, server workers) record events.
+ *
+ * Events are stamped with the time stamp counter where there is one and converted to nanoseconds when dumped,
+ * reading it is several times cheaper than std::chrono::steady_clock.
+ */
+#ifdef WL_ENABLE_TRACING
+
+#include <chrono>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace Trace
+{
+	inline constexpr uint32_t RING_CAPACITY = 1u << 16;
+
+	// Name has to outlive the dump, only the pointer is stored. Start and Duration are in ticks.
+	struct Event
+	{
+		const char* Name;
+		int64_t Start;
+		int64_t Duration;
+		uint64_t ExpressionId;
+		uint64_t InputSize;
+	};
+
+	[[nodiscard]] inline int64_t GetTicks()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return static_cast<int64_t>(__rdtsc());
+#else
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	void Record(const char* Name, int64_t Start, int64_t End, uint64_t InputSize);
+
+	// Expression id attached to the events of the calling thread, returns the previous one
+	uint64_t SetExpression(uint64_t ExpressionId);
+
+	// Safe to call while other threads record, events they overwrite during the copy are left out
+	void AppendJson(std::string& OutText);
+	bool WriteJson(const char* Path);
+
+	class Scope
+	{
+	public:
+		Scope(const char* Name, const uint64_t InputSize)
+			: Name(Name),
+			  InputSize(InputSize),
+			  Start(GetTicks())
+		{
+		}
+
+		~Scope()
+		{
+			Record(Name, Start, GetTicks(), InputSize);
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		// Protected fields and functions
+	protected:
+		const char* Name;
+		uint64_t InputSize;
+		int64_t Start;
+	};
+
+	class ExpressionScope
+	{
+	public:
+		explicit ExpressionScope(const uint64_t ExpressionId)
+			: Previous(SetExpression(ExpressionId))
+		{
+		}
+
+		~ExpressionScope()
+		{
+			SetExpression(Previous);
+		}
+
+		ExpressionScope(const ExpressionScope&) = delete;
+		ExpressionScope& operator=(const ExpressionScope&) = delete;
+
+		// Protected fields and functions
+	protected:
+		uint64_t Previous;
+	};
+}
+
+#define WL_TRACE_CONCAT_INNER(Left, Right) Left##Right
+#define WL_TRACE_CONCAT(Left, Right) WL_TRACE_CONCAT_INNER(Left, Right)
+
+#define WL_TRACE_SCOPE(Name, InputSize) const Trace::Scope WL_TRACE_CONCAT(TraceScope, __LINE__)(Name, static_cast<uint64_t>(InputSize))
+#define WL_TRACE_EXPRESSION(ExpressionId) const Trace::ExpressionScope WL_TRACE_CONCAT(TraceExpression, __LINE__)(static_cast<uint64_t>(ExpressionId))
+
+#else
+
+#define WL_TRACE_SCOPE(Name, InputSize) ((void)0)
+#define WL_TRACE_EXPRESSION(ExpressionId) ((void)0)
+
+#endif
@@ -2,11 +2,21 @@
 #include "Pch.h"
 
 #include "UI.h"
+#include "DiagnosticRenderer.h"
 #include "ErrorManager.h"
+#include "EvaluationBudget.h"
+#include "Interpreter/DirectEvaluator.h"
+#include "Interpreter/EvaluationProfile.h"
 #include "Interpreter/Interpreter.h"
+#include "Interpreter/NumberFormat.h"
+#include "Interpreter/ParallelInterpreter.h"
+#include "Interpreter/RationalInterpreter.h"
+#include "Jit/Jit.h"
 #include "Lexer/Lexer.h"
+#include "Lexer/ParallelLexer.h"
 #include "Parser/NodeTypes.h"
 #include "Parser/Parser.h"
+#include "Trace.h"
 
 static constexpr int NUM_FRAMES_IN_FLIGHT = 3;
 static constexpr int NUM_BACK_BUFFERS = 3;
@@ -26,6 +36,52 @@ static HANDLE GSwapChainWaitableObject = nullptr;
 static ID3D12Resource* GMainRenderTargetResource[NUM_BACK_BUFFERS] = {};
 static D3D12_CPU_DESCRIPTOR_HANDLE GMainRenderTargetDescriptor[NUM_BACK_BUFFERS] = {};
 
+// Formats into a stack buffer and reuses the capacity of OutResult, so no allocation once the string has grown
+static void FormatResult(std::string& OutResult, const Number& Result)
+{
+	char Buffer[NumberFormat::MAX_LENGTH];
+	const char* End = NumberFormat::Format(Buffer, Buffer + sizeof(Buffer), Result);
+
+	OutResult.assign(Buffer, End);
+}
+
+// Fractions are followed by their decimal value
+static std::string GetResultString(const Rational& Result)
+{
+	if (Result.IsInteger())
+	{
+		return Result.ToString();
+	}
+
+	return std::format("{} = {}", Result.ToString(), Result.ToLongDouble());
+}
+
+// Pasted input of several megabytes is lexed on every core before parsing, anything shorter is lexed while parsing.
+// The parallel lexer leaves no tokens after an illegal character, the tree then only holds an error node. It takes no
+// budget, so the length is checked before it runs and its tokens are charged after, one operation each like the
+// serial lexer does.
+static uint32_t ParseInput(const std::string_view Input, SyntaxTree& OutTree, ErrorManager& Errors, EvaluationBudget& Budget)
+{
+	if (Input.size() < ParallelLexer::MIN_CHUNK_SIZE * 2)
+	{
+		return Parser::GetExpressionResult(Input, OutTree, Errors, &Budget);
+	}
+
+	std::pmr::vector<Token> Tokens;
+
+	if (Budget.CheckInputLength(Input.size(), Errors))
+	{
+		Tokens = ParallelLexer::GetTokens(Input, Errors);
+	}
+
+	if (Tokens.empty() || !Budget.Spend(Errors, 0, static_cast<int32_t>(Input.size()), Tokens.size()))
+	{
+		return OutTree.AddNode({ NODE_TYPE_ERROR, TYPE_EOF, INVALID_NODE, INVALID_NODE, 0, 0 });
+	}
+
+	return Parser::GetExpressionResult(Tokens, OutTree, Errors, &Budget);
+}
+
 // Main code
 void SetupAndRun()
 {
@@ -103,6 +159,20 @@ void SetupAndRun()
 		{
 			static std::string ResultString = "0";
 			static std::string InputBuffer;
+			static std::string LastEvaluatedInput;
+			static ErrorManager Errors;
+			static ErrorManager PartialErrors;
+			static SyntaxTree Tree;
+			static bool ExactMode = false;
+			static bool ProfileMode = false;
+			static bool NativeMode = false;
+			static EvaluationProfile Profile;
+			static std::pmr::string ProfileReport;
+			static DiagnosticRenderer Diagnostics;
+			static uint64_t Revision = 0;
+
+			// Pasted input must not overflow the parser's stack or freeze the window
+			static const EvaluationLimits Limits = { .MaxDepth = 1024, .MaxDuration = std::chrono::seconds(1) };
 
 			ImGui::SetNextWindowPos(ImVec2(0, 0));
 			ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
@@ -111,32 +181,92 @@ void SetupAndRun()
 			ImGui::Text("Input: ");
 			ImGui::SameLine();
 
-			if (ImGui::InputText("##Input", &InputBuffer))
+			const bool InputChanged = ImGui::InputText("##Input", &InputBuffer) && InputBuffer != LastEvaluatedInput;
+
+			ImGui::SameLine();
+			bool ModeChanged = ImGui::Checkbox("Exact", &ExactMode);
+
+			ImGui::SameLine();
+			ModeChanged |= ImGui::Checkbox("Profile", &ProfileMode);
+
+			ImGui::SameLine();
+			ModeChanged |= ImGui::Checkbox("Native", &NativeMode);
+
+			// Only re-run the pipeline when the text or the mode actually changed
+			if (InputChanged || ModeChanged)
 			{
+				LastEvaluatedInput = InputBuffer;
+				Errors.Clear();
+				Revision++;
+				ProfileReport.clear();
+
 				if (!InputBuffer.empty())
 				{
-					// Run lexer
-					std::vector<Token> Tokens = Lexer::GetTokens(InputBuffer);
+					WL_TRACE_EXPRESSION(Revision);
 
-					if (ErrorManager::CheckLastError())
+					Number Result;
+					EvaluationBudget Budget(Limits);
+
+					// Well formed input needs no diagnostics, evaluate it without building tokens or a tree
+					if (!ExactMode && !ProfileMode && !NativeMode && DirectEvaluator::TryEvaluate(InputBuffer, Result))
+					{
+						FormatResult(ResultString, Result);
+					}
+					else
 					{
-						// Run parser
-						NodeBase* SyntaxTreeRoot = Parser::GetExpressionResult(Tokens);
+						// Lex and parse in one pass, syntax errors are recovered from so whatever could be parsed is still evaluated
+						Tree.Clear();
+						const uint32_t SyntaxTreeRoot = ParseInput(InputBuffer, Tree, Errors, Budget);
 
-						if (ErrorManager::CheckLastError())
+						if (Tree.GetNode(SyntaxTreeRoot).Type != NODE_TYPE_ERROR && !Budget.IsExhausted())
 						{
-							// Run interpreter
-							const Number Result = Interpreter::Visit(SyntaxTreeRoot);
+							// Runtime errors of a partial tree are not reported on top of the syntax errors
+							const bool IsPartial = Errors.HasErrors();
+							PartialErrors.Clear();
+							ErrorManager& RuntimeErrors = IsPartial ? PartialErrors : Errors;
+
+							// Run interpreter, exact mode falls back to floating point for literals that overflowed
+							std::optional<Rational> ExactResult;
+
+							if (ExactMode)
+							{
+								WL_TRACE_SCOPE("InterpretExact", Tree.Nodes.size());
+								ExactResult = RationalInterpreter::Visit(Tree, SyntaxTreeRoot, RuntimeErrors, &Budget, InputBuffer);
+							}
+
+							if (!ExactResult && ProfileMode)
+							{
+								Profile.Clear();
+								Result = Interpreter::Visit(Tree, SyntaxTreeRoot, RuntimeErrors, Profile, &Budget);
+								Profile.AppendHeatmap(ProfileReport, Tree, SyntaxTreeRoot, InputBuffer);
+							}
+							else if (!ExactResult && NativeMode)
+							{
+								// Compiles to x86-64 code, falls back to the interpreter when Number is not built on doubles
+								WL_TRACE_SCOPE("InterpretNative", Tree.Nodes.size());
+								const std::unique_ptr<CompiledExpression> Compiled = Jit::Compile(Tree, SyntaxTreeRoot);
+								Result = Jit::Evaluate(Compiled.get(), Tree, SyntaxTreeRoot, RuntimeErrors);
+							}
+							else if (!ExactResult)
+							{
+								// Pasted expressions can be large enough to split across cores
+								Result = ParallelInterpreter::Visit(Tree, SyntaxTreeRoot, RuntimeErrors);
+							}
 
-							if (ErrorManager::CheckLastError())
+							if (!RuntimeErrors.HasErrors())
 							{
-								if (Result.IsInt)
+								if (ExactResult)
 								{
-									ResultString = std::format("{}", Result.IntValue);
+									ResultString = GetResultString(*ExactResult);
 								}
 								else
 								{
-									ResultString = std::format("{}", Result.LongDoubleValue);
+									FormatResult(ResultString, Result);
+								}
+
+								if (IsPartial)
+								{
+									ResultString += " (partial)";
 								}
 							}
 						}
@@ -151,16 +281,16 @@ void SetupAndRun()
 			ImGui::SameLine();
 			ImGui::Text("Result: %s", ResultString.c_str());
 
-			// Print error details if error was found
-			if (!ErrorManager::CheckLastError())
+			// Print error details for every error that was found, only rendered again after the input changed
+			if (Errors.HasErrors())
+			{
+				const std::pmr::string& DiagnosticText = Diagnostics.Render(InputBuffer, Revision, Errors);
+				ImGui::TextUnformatted(DiagnosticText.data(), DiagnosticText.data() + DiagnosticText.size());
+			}
+
+			if (!ProfileReport.empty())
 			{
-				const Error* LastError = ErrorManager::GetLastError();
-				ImGui::Text(
-					"%s\n"
-					"Error: %s -> %s",
-					LastError->StringWithArrows(InputBuffer).c_str(),
-					LastError->ErrorName.c_str(),
-					LastError->Details.c_str());
+				ImGui::TextUnformatted(ProfileReport.data(), ProfileReport.data() + ProfileReport.size());
 			}
 
 			ImGui::End();
@@ -208,6 +338,10 @@ void SetupAndRun()
 
 	WaitForLastSubmittedFrame();
 
+#ifdef WL_ENABLE_TRACING
+	(void)Trace::WriteJson("LiveCalculator.trace.json");
+#endif
+
 	// Cleanup
 	ImGui_ImplDX12_Shutdown();
 	ImGui_ImplWin32_Shutdown();
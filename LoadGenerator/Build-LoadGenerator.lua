@@ -0,0 +1,47 @@
+project "LoadGenerator"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	-- Benchmark client for EvalServer, shares its wire protocol
+	files
+	{
+		"src/**.cpp",
+		"../EvalServer/src/Protocol.h",
+		"../LiveCalculator/src/Pch.h",
+		"../LiveCalculator/src/Pch.cpp"
+	}
+
+	includedirs
+	{
+		"./src",
+		"../EvalServer/src",
+		"../LiveCalculator/src"
+	}
+
+	pchheader "Pch.h"
+	pchsource "../LiveCalculator/src/Pch.cpp"
+
+	targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+	filter "system:linux"
+		links { "pthread" }
+
+	filter "configurations:Debug"
+		defines { "WL_DEBUG" }
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "WL_RELEASE" }
+		runtime "Release"
+		optimize "On"
+		symbols "On"
+
+	filter "configurations:Dist"
+		defines { "WL_DIST" }
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
\ No newline at end of file
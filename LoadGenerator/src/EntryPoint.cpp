@@ -0,0 +1,325 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Protocol.h"
+
+#include <chrono>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions
+{
+	std::string SocketPath;
+	uint16_t Port = 0;
+	uint32_t ConnectionCount = 8;
+	uint32_t RequestCount = 100000;
+
+	// Requests each connection keeps in flight
+	uint32_t PipelineDepth = 16;
+};
+
+struct ConnectionResult
+{
+	std::vector<Clock::duration> Latencies;
+	uint64_t ErrorCount = 0;
+	bool Failed = false;
+};
+
+// Mix of cheap formulas and ones that need the full pipeline
+static const std::string GFormulas[] =
+{
+	"1 + 2",
+	"2 * (3 + 4) - 5 / 7",
+	"((1.5e3 - 0x10) * 3) / (2 - 0.25)",
+	"1_000_000 * 1_000_000 - 7",
+	"-(-(-(4.25 * 8)))",
+	"(((((((((1 + 2) * 3) - 4) / 5) + 6) * 7) - 8) / 9) + 10)",
+	"1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11 + 12 + 13 + 14 + 15 + 16 + 17 + 18 + 19 + 20"
+};
+
+static int Connect(const LoadOptions& Options)
+{
+	int Socket;
+
+	if (!Options.SocketPath.empty())
+	{
+		sockaddr_un Address = {};
+		Address.sun_family = AF_UNIX;
+		std::copy_n(Options.SocketPath.begin(), std::min(Options.SocketPath.size(), sizeof(Address.sun_path) - 1), Address.sun_path);
+
+		Socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+		if (Socket >= 0 && connect(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) == 0)
+		{
+			return Socket;
+		}
+	}
+	else
+	{
+		sockaddr_in Address = {};
+		Address.sin_family = AF_INET;
+		Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		Address.sin_port = htons(Options.Port);
+
+		Socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+		if (Socket >= 0 && connect(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) == 0)
+		{
+			const int Enable = 1;
+			setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &Enable, sizeof(Enable));
+			return Socket;
+		}
+	}
+
+	printf("Failed to connect: %s\n", strerror(errno));
+
+	if (Socket >= 0)
+	{
+		close(Socket);
+	}
+
+	return -1;
+}
+
+static void AppendRequest(std::vector<char>& Buffer, const uint32_t Id)
+{
+	const std::string& Formula = GFormulas[Id % std::size(GFormulas)];
+
+	const Protocol::RequestHeader Header = { static_cast<uint32_t>(Formula.size()), Id };
+	const char* HeaderBytes = reinterpret_cast<const char*>(&Header);
+
+	Buffer.insert(Buffer.end(), HeaderBytes, HeaderBytes + sizeof(Header));
+	Buffer.insert(Buffer.end(), Formula.begin(), Formula.end());
+}
+
+static bool SendAll(const int Socket, const std::vector<char>& Buffer)
+{
+	size_t Offset = 0;
+
+	while (Offset < Buffer.size())
+	{
+		const ssize_t Count = send(Socket, Buffer.data() + Offset, Buffer.size() - Offset, MSG_NOSIGNAL);
+
+		if (Count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		Offset += static_cast<size_t>(Count);
+	}
+
+	return true;
+}
+
+// Keeps PipelineDepth requests in flight and times each one from send to response
+static void RunConnection(const LoadOptions& Options, ConnectionResult& Result)
+{
+	const int Socket = Connect(Options);
+
+	if (Socket < 0)
+	{
+		Result.Failed = true;
+		return;
+	}
+
+	std::vector<Clock::time_point> SentAt(Options.RequestCount);
+	std::vector<char> SendBuffer;
+	std::vector<char> ReadBuffer;
+	uint32_t SentCount = 0;
+	uint32_t ReceivedCount = 0;
+
+	Result.Latencies.reserve(Options.RequestCount);
+
+	const auto SendMore = [&](const uint32_t Count)
+	{
+		SendBuffer.clear();
+		const Clock::time_point Now = Clock::now();
+
+		for (uint32_t Index = 0; Index < Count && SentCount < Options.RequestCount; ++Index)
+		{
+			SentAt[SentCount] = Now;
+			AppendRequest(SendBuffer, SentCount++);
+		}
+
+		return SendAll(Socket, SendBuffer);
+	};
+
+	if (!SendMore(Options.PipelineDepth))
+	{
+		Result.Failed = true;
+	}
+
+	char Chunk[16384];
+
+	while (!Result.Failed && ReceivedCount < Options.RequestCount)
+	{
+		const ssize_t Count = recv(Socket, Chunk, sizeof(Chunk), 0);
+
+		if (Count <= 0)
+		{
+			if (Count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			printf("Connection closed after %u of %u responses\n", ReceivedCount, Options.RequestCount);
+			Result.Failed = true;
+			break;
+		}
+
+		ReadBuffer.insert(ReadBuffer.end(), Chunk, Chunk + Count);
+
+		const Clock::time_point Now = Clock::now();
+		size_t Offset = 0;
+		uint32_t Completed = 0;
+
+		while (ReadBuffer.size() - Offset >= sizeof(Protocol::ResponseHeader))
+		{
+			Protocol::ResponseHeader Header;
+			std::memcpy(&Header, ReadBuffer.data() + Offset, sizeof(Header));
+
+			if (ReadBuffer.size() - Offset - sizeof(Header) < Header.Length)
+			{
+				break;
+			}
+
+			if (Header.Id >= SentCount)
+			{
+				printf("Response for unknown request %u\n", Header.Id);
+				Result.Failed = true;
+				break;
+			}
+
+			Result.Latencies.push_back(Now - SentAt[Header.Id]);
+			Result.ErrorCount += Header.Status != Protocol::STATUS_OK;
+
+			Offset += sizeof(Header) + Header.Length;
+			Completed++;
+		}
+
+		ReadBuffer.erase(ReadBuffer.begin(), ReadBuffer.begin() + static_cast<ptrdiff_t>(Offset));
+		ReceivedCount += Completed;
+
+		if (Completed > 0 && !SendMore(Completed))
+		{
+			Result.Failed = true;
+		}
+	}
+
+	close(Socket);
+}
+
+static double GetMicroseconds(const Clock::duration Duration)
+{
+	return std::chrono::duration<double, std::micro>(Duration).count();
+}
+
+/*
+ * Load generator for EvalServer.
+ * Usage: LoadGenerator [--unix <path>] [--port <port>] [--connections <count>] [--requests <per connection>] [--pipeline <depth>]
+ *
+ * Connects to /tmp/LiveCalculator.sock when neither --unix nor --port is given, then reports throughput and latency.
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	LoadOptions Options;
+
+	for (int ArgumentIndex = 1; ArgumentIndex < ArgumentCount; ArgumentIndex += 2)
+	{
+		const std::string_view Name = Arguments[ArgumentIndex];
+
+		if (ArgumentIndex + 1 == ArgumentCount)
+		{
+			printf("Missing value for %s\n", Arguments[ArgumentIndex]);
+			return 1;
+		}
+
+		const char* Value = Arguments[ArgumentIndex + 1];
+
+		if (Name == "--unix")
+		{
+			Options.SocketPath = Value;
+		}
+		else if (Name == "--port")
+		{
+			Options.Port = static_cast<uint16_t>(std::atoi(Value));
+		}
+		else if (Name == "--connections")
+		{
+			Options.ConnectionCount = std::max(std::atoi(Value), 1);
+		}
+		else if (Name == "--requests")
+		{
+			Options.RequestCount = std::max(std::atoi(Value), 1);
+		}
+		else if (Name == "--pipeline")
+		{
+			Options.PipelineDepth = std::max(std::atoi(Value), 1);
+		}
+		else
+		{
+			printf("Usage: LoadGenerator [--unix <path>] [--port <port>] [--connections <count>] [--requests <per connection>] [--pipeline <depth>]\n");
+			return 1;
+		}
+	}
+
+	if (Options.SocketPath.empty() && Options.Port == 0)
+	{
+		Options.SocketPath = "/tmp/LiveCalculator.sock";
+	}
+
+	std::vector<ConnectionResult> Results(Options.ConnectionCount);
+	std::vector<std::thread> Threads;
+
+	const Clock::time_point Start = Clock::now();
+
+	for (ConnectionResult& Result : Results)
+	{
+		Threads.emplace_back(RunConnection, std::cref(Options), std::ref(Result));
+	}
+
+	for (std::thread& Thread : Threads)
+	{
+		Thread.join();
+	}
+
+	const Clock::duration Elapsed = Clock::now() - Start;
+
+	std::vector<Clock::duration> Latencies;
+	uint64_t ErrorCount = 0;
+
+	for (const ConnectionResult& Result : Results)
+	{
+		if (Result.Failed)
+		{
+			return 1;
+		}
+
+		Latencies.insert(Latencies.end(), Result.Latencies.begin(), Result.Latencies.end());
+		ErrorCount += Result.ErrorCount;
+	}
+
+	std::sort(Latencies.begin(), Latencies.end());
+
+	const auto GetPercentile = [&](const double Percentile)
+	{
+		return GetMicroseconds(Latencies[std::min(static_cast<size_t>(Percentile * static_cast<double>(Latencies.size())), Latencies.size() - 1)]);
+	};
+
+	printf("%zu requests over %u connections, pipeline depth %u\n", Latencies.size(), Options.ConnectionCount, Options.PipelineDepth);
+	printf("throughput %.0f requests/s\n", static_cast<double>(Latencies.size()) / std::chrono::duration<double>(Elapsed).count());
+	printf("latency p50 %.1f us, p99 %.1f us, max %.1f us\n", GetPercentile(0.50), GetPercentile(0.99), GetMicroseconds(Latencies.back()));
+	printf("error responses %llu\n", static_cast<unsigned long long>(ErrorCount));
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+project "Tests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "off"
+
+	-- Core sources without the UI, run with "Tests [name filter]"
+	files
+	{
+		"src/**.h",
+		"src/**.cpp",
+		"../LiveCalculator/src/**.h",
+		"../LiveCalculator/src/**.cpp"
+	}
+
+	removefiles
+	{
+		"../LiveCalculator/src/EntryPoint.cpp",
+		"../LiveCalculator/src/UI.h",
+		"../LiveCalculator/src/UI.cpp"
+	}
+
+	includedirs
+	{
+		"./src",
+		"../LiveCalculator/src",
+		"../vendor/imgui"
+	}
+
+	pchheader "Pch.h"
+	pchsource "../LiveCalculator/src/Pch.cpp"
+
+	targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+	filter "system:windows"
+		systemversion "latest"
+		defines { "WL_PLATFORM_WINDOWS" }
+
+	filter "system:linux"
+		links { "pthread" }
+
+	filter "configurations:Debug"
+		defines { "WL_DEBUG" }
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "WL_RELEASE" }
+		runtime "Release"
+		optimize "On"
+		symbols "On"
+
+	filter "configurations:Dist"
+		defines { "WL_DIST" }
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
@@ -0,0 +1,146 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "EvaluationContext.h"
+
+#include <cstdlib>
+#include <new>
+
+// Global operator new is replaced for the whole test binary, it only counts while GIsCounting is set
+static std::atomic<bool> GIsCounting = false;
+static std::atomic<uint64_t> GAllocationCount = 0;
+
+// The engine never asks for over-aligned storage, so the align_val_t forms need no counting
+static_assert(alignof(Number) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+void* operator new(const size_t Size)
+{
+	if (GIsCounting.load(std::memory_order_relaxed))
+	{
+		GAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (void* Memory = std::malloc(Size != 0 ? Size : 1))
+	{
+		return Memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](const size_t Size)
+{
+	return operator new(Size);
+}
+
+void* operator new(const size_t Size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return operator new(Size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](const size_t Size, const std::nothrow_t& Tag) noexcept
+{
+	return operator new(Size, Tag);
+}
+
+void operator delete(void* Memory) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete(void* Memory, size_t) noexcept
+{
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory, size_t) noexcept
+{
+	std::free(Memory);
+}
+
+// Number of allocations Function made
+template <typename TFunction>
+static uint64_t CountAllocations(const TFunction& Function)
+{
+	const uint64_t CountBefore = GAllocationCount.load();
+
+	GIsCounting = true;
+	Function();
+	GIsCounting = false;
+
+	return GAllocationCount.load() - CountBefore;
+}
+
+/*
+ * EvaluationContext promises no heap use after Reserve(MaxInputLength) for inputs of up to that length. Checked
+ * from the first evaluation on, in every sum mode, over well formed input that the direct evaluator takes, long
+ * chains that are flattened, nested brackets, runtime errors and syntax errors. Built with "premake5 --tracing"
+ * the trace events allocate, this test only holds without it.
+ */
+WL_TEST(EvaluationContextDoesNotAllocateAfterReserve)
+{
+	static constexpr size_t MAX_INPUT_LENGTH = 4096;
+
+	std::vector<std::string> Corpus =
+	{
+		"1 + 2 * 3",
+		"0x7f * 1_000 - 2.5e-3 / 7.",
+		"1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 0.5",
+		"0.1 - (0.2 + 0.3 + 0.4 + 0.5 + 0.6 + 0.7 + 0.8 + 0.9) * (1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 - 9)",
+		"((((((((1 + 2) * 3) - 4) / 5) + 6) * 7) - 8) / 9)",
+		"1 / 0 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9",
+		"1 + * 2 ) (",
+		"(((1 + 2",
+		"1 $ 2",
+		"99999999999999999999 + 1e99999"
+	};
+
+	std::mt19937_64 Random(47);
+
+	while (Corpus.size() < 400)
+	{
+		std::string Formula = Test::GenerateFormula(Random, 6);
+
+		if (Formula.size() <= MAX_INPUT_LENGTH)
+		{
+			Corpus.push_back(std::move(Formula));
+		}
+	}
+
+	for (const ESumMode SumMode : { SUM_MODE_STRICT, SUM_MODE_PAIRWISE, SUM_MODE_COMPENSATED })
+	{
+		EvaluationContext Context;
+		Context.SetSumMode(SumMode);
+		Context.Reserve(MAX_INPUT_LENGTH);
+
+		for (const std::string& Formula : Corpus)
+		{
+			Number Result;
+			const uint64_t AllocationCount = CountAllocations([&]
+			{
+				Result = Context.Evaluate(Formula);
+			});
+
+			WL_CHECK(AllocationCount == 0);
+
+			if (AllocationCount != 0)
+			{
+				printf("  %llu allocations in mode %d for %s\n", static_cast<unsigned long long>(AllocationCount), SumMode, Formula.c_str());
+			}
+		}
+	}
+}
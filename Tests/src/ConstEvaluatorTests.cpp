@@ -0,0 +1,86 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "Interpreter/ConstEvaluator.h"
+#include "Interpreter/NumberPolicy.h"
+
+#include <cstdlib>
+#include <random>
+
+// Evaluated by the compiler, a wrong result fails the build
+static_assert(LiveCalc::Eval<"2*(3+4)">().IntValue == 14);
+static_assert(LiveCalc::Eval<"1_000 + 0x10 - -2">().IntValue == 1018);
+static_assert(LiveCalc::Eval<"9223372036854775807 + 1">().IntValue == INT64_MIN);
+static_assert(!LiveCalc::Eval<"7 / 2">().IsInt);
+static_assert(LiveCalc::Eval<"0.1">().FloatValue == static_cast<Number::FloatType>(0.1L));
+static_assert(LiveCalc::Detail::ParseFloat<double>("1e300") == 1e300);
+static_assert(LiveCalc::Detail::ParseFloat<double>("123456789012345678901234567890e-10") == 12345678901234567890.123456789);
+static_assert(LiveCalc::Detail::ParseFloat<double>("9007199254740993") == 9007199254740992.0);
+static_assert(LiveCalc::Detail::ParseFloat<double>("1.7976931348623159e308") == std::numeric_limits<double>::infinity());
+static_assert(LiveCalc::Detail::ParseFloat<double>("2.4703282292062328e-324") == std::numeric_limits<double>::denorm_min());
+static_assert(LiveCalc::Detail::ParseFloat<float>("3.4028235e38") == std::numeric_limits<float>::max());
+
+// The runtime pipeline has to give the same bits for Source
+template <LiveCalc::FixedString Source>
+static bool MatchesPipeline()
+{
+	bool HasErrors = false;
+	const Number Expected = Test::Evaluate(Source.View(), &HasErrors);
+	return !HasErrors && LiveCalc::Eval<Source>().IsIdenticalTo(Expected);
+}
+
+WL_TEST(ConstEvalMatchesPipeline)
+{
+	WL_CHECK(MatchesPipeline<"2*(3+4) - 5/7">());
+	WL_CHECK(MatchesPipeline<"-(-(-(4.25 * 8)))">());
+	WL_CHECK(MatchesPipeline<"1_000_000 * 1_000_000 - 7">());
+	WL_CHECK(MatchesPipeline<"((1.5e3 - 0x10) * 3) / (2 - 0.25)">());
+	WL_CHECK(MatchesPipeline<"12345678901234567890123.0">());
+	WL_CHECK(MatchesPipeline<"123456789012345678901234567890e-10">());
+	WL_CHECK(MatchesPipeline<"1e300*1e5">());
+	WL_CHECK(MatchesPipeline<"0.1 + 0.2">());
+	WL_CHECK(MatchesPipeline<"1e-320 * 3">());
+	WL_CHECK(MatchesPipeline<"2.2250738585072011e-308">());
+	WL_CHECK(MatchesPipeline<"1e400">());
+	WL_CHECK(MatchesPipeline<"0.000_000_1e-7">());
+}
+
+template <typename T>
+static bool ParsesLikeRuntime(const std::string& Digits, T (*Parse)(const char*, char**))
+{
+	const T Expected = Parse(Digits.c_str(), nullptr);
+	const T Actual = LiveCalc::Detail::ParseFloat<T>(Digits);
+	return std::memcmp(&Expected, &Actual, sizeof(T)) == 0 || Expected == Actual;
+}
+
+WL_TEST(ParseFloatIsCorrectlyRounded)
+{
+	std::mt19937_64 Random(1);
+
+	for (int32_t Iteration = 0; Iteration < 20000; ++Iteration)
+	{
+		// Up to 40 digits with the point anywhere, exponents across and past the range of every policy
+		std::string Digits;
+		const uint64_t DigitCount = 1 + Random() % 40;
+		const uint64_t PointIndex = Random() % (DigitCount + 1);
+
+		for (uint64_t Index = 0; Index < DigitCount; ++Index)
+		{
+			if (Index == PointIndex)
+			{
+				Digits += '.';
+			}
+
+			Digits += static_cast<char>('0' + Random() % 10);
+		}
+
+		const int32_t ExponentRange = Random() % 2 == 0 ? 700 : 10000;
+		Digits += std::format("e{}", static_cast<int32_t>(Random() % ExponentRange) - ExponentRange / 2);
+
+		WL_CHECK(ParsesLikeRuntime<double>(Digits, std::strtod));
+		WL_CHECK(ParsesLikeRuntime<float>(Digits, std::strtof));
+		WL_CHECK(ParsesLikeRuntime<long double>(Digits, std::strtold));
+	}
+}
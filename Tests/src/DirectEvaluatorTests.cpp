@@ -0,0 +1,67 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/DirectEvaluator.h"
+
+// Every input TryEvaluate accepts has to give the full pipeline's result, the pipeline must not report anything for it
+static void CheckAgainstPipeline(const std::string& Formula, ErrorManager& Scratch, uint32_t& AcceptedCount)
+{
+	bool HasErrors = false;
+	const Number Expected = Test::Evaluate(Formula, &HasErrors);
+	Number Result;
+
+	if (DirectEvaluator::TryEvaluate(Formula, Result, Scratch))
+	{
+		AcceptedCount++;
+		WL_CHECK(!HasErrors);
+		WL_CHECK(Result.IsIdenticalTo(Expected));
+	}
+
+	WL_CHECK(!Scratch.HasErrors());
+}
+
+WL_TEST(DirectEvaluatorMatchesPipeline)
+{
+	std::mt19937_64 Random(33);
+	ErrorManager Scratch;
+	uint32_t AcceptedCount = 0;
+
+	for (int32_t Iteration = 0; Iteration < 20000; ++Iteration)
+	{
+		CheckAgainstPipeline(Test::GenerateFormula(Random, 6), Scratch, AcceptedCount);
+	}
+
+	// Well formed input without a division by zero is the case TryEvaluate exists for
+	WL_CHECK(AcceptedCount > 10000);
+}
+
+WL_TEST(DirectEvaluatorRejectsMalformedInput)
+{
+	static constexpr char ALPHABET[] = "0123456789.+-*/() \texX_";
+
+	std::mt19937_64 Random(330);
+	ErrorManager Scratch;
+	uint32_t AcceptedCount = 0;
+
+	for (int32_t Iteration = 0; Iteration < 50000; ++Iteration)
+	{
+		std::string Formula;
+		const uint64_t Length = Random() % 24;
+
+		for (uint64_t Index = 0; Index < Length; ++Index)
+		{
+			Formula += ALPHABET[Random() % (sizeof(ALPHABET) - 1)];
+		}
+
+		CheckAgainstPipeline(Formula, Scratch, AcceptedCount);
+	}
+
+	// Deeper than the stacks, the pipeline still evaluates it
+	const std::string Nested = std::string(DirectEvaluator::MAX_STACK_DEPTH + 1, '(') + "1" + std::string(DirectEvaluator::MAX_STACK_DEPTH + 1, ')');
+	Number Result;
+	WL_CHECK(!DirectEvaluator::TryEvaluate(Nested, Result));
+	WL_CHECK(Test::Evaluate(Nested).IntValue == 1);
+}
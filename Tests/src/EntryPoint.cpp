@@ -0,0 +1,42 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+/*
+ * Runs every registered test, or only those whose name contains the first argument.
+ * Usage: Tests [name filter]
+ *
+ * The exit code is the number of tests that failed.
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	const std::string_view Filter = ArgumentCount > 1 ? Arguments[1] : "";
+	int32_t FailedTests = 0;
+	int32_t RunTests = 0;
+
+	for (const Test::TestCase& Case : Test::GetTests())
+	{
+		if (std::string_view(Case.Name).find(Filter) == std::string_view::npos)
+		{
+			continue;
+		}
+
+		const uint32_t FailuresBefore = Test::GetFailureCount();
+		Case.Function();
+		RunTests++;
+
+		if (Test::GetFailureCount() != FailuresBefore)
+		{
+			printf("[FAILED] %s\n", Case.Name);
+			FailedTests++;
+		}
+		else
+		{
+			printf("[PASSED] %s\n", Case.Name);
+		}
+	}
+
+	printf("%d of %d tests passed\n", RunTests - FailedTests, RunTests);
+	return FailedTests;
+}
@@ -0,0 +1,209 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "Cache/ExpressionCache.h"
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+
+#include <filesystem>
+#include <fstream>
+
+static const std::string GFormulas[] =
+{
+	"1 + 2",
+	"2 * (3 + 4) - 5 / 7",
+	"((1.5e3 - 0x10) * 3) / (2 - 0.25)",
+	"1_000_000 * 1_000_000 - 7",
+	"-(-(-(4.25 * 8)))",
+	"1 / 0"
+};
+
+static std::string GetCachePath(const char* Name)
+{
+	return (std::filesystem::temp_directory_path() / Name).string();
+}
+
+// Runs on several threads at once, so it reports through the result instead of WL_CHECK
+static bool WriteCache(const std::string& Path)
+{
+	ExpressionCacheWriter Writer;
+	ErrorManager Errors;
+	bool IsAdded = true;
+
+	for (const std::string& Formula : GFormulas)
+	{
+		IsAdded = Writer.Add(Formula, Errors) && IsAdded;
+	}
+
+	// Syntax errors are not stored
+	IsAdded = !Writer.Add("1 +", Errors) && IsAdded;
+
+	return IsAdded && Writer.Write(Path);
+}
+
+static std::string ReadFile(const std::string& Path)
+{
+	std::ifstream File(Path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+}
+
+WL_TEST(ExpressionCacheRoundTrip)
+{
+	const std::string Path = GetCachePath("LiveCalculatorTests.cache");
+	WL_CHECK(WriteCache(Path));
+
+	ExpressionCache Cache;
+	WL_CHECK(Cache.Open(Path));
+
+	for (const std::string& Formula : GFormulas)
+	{
+		uint32_t Root = 0;
+		WL_CHECK(Cache.Find(Formula, Root));
+
+		bool HasErrors = false;
+		const Number Expected = Test::Evaluate(Formula, &HasErrors);
+
+		ErrorManager Errors;
+		const Number Result = Interpreter::Visit(Cache.GetTree(), Root, Errors);
+		WL_CHECK(Errors.HasErrors() == HasErrors);
+		WL_CHECK(HasErrors || Result.IsIdenticalTo(Expected));
+	}
+
+	uint32_t Root = 0;
+	WL_CHECK(!Cache.Find("1 +", Root));
+	WL_CHECK(!Cache.Find("1 + 3", Root));
+
+	Cache.Close();
+	std::filesystem::remove(Path);
+}
+
+WL_TEST(ExpressionCacheRejectsCorruptFiles)
+{
+	const std::string Path = GetCachePath("LiveCalculatorTestsCorrupt.cache");
+	WL_CHECK(WriteCache(Path));
+
+	const uintmax_t Size = std::filesystem::file_size(Path);
+
+	// Any flipped byte outside the reserved header field fails the header checks or the checksum. Every header byte
+	// is tried, the number policy fields are not covered by the checksum.
+	for (uintmax_t Offset = 0; Offset < Size; Offset += Offset < sizeof(ExpressionCacheFormat::Header) ? 1 : 7)
+	{
+		if (Offset >= offsetof(ExpressionCacheFormat::Header, Reserved) && Offset < sizeof(ExpressionCacheFormat::Header))
+		{
+			continue;
+		}
+
+		std::fstream File(Path, std::ios::binary | std::ios::in | std::ios::out);
+		File.seekg(static_cast<std::streamoff>(Offset));
+		const char Original = static_cast<char>(File.get());
+		File.seekp(static_cast<std::streamoff>(Offset));
+		File.put(static_cast<char>(Original ^ 0x5A));
+		File.close();
+
+		ExpressionCache Cache;
+		WL_CHECK(!Cache.Open(Path));
+
+		File.open(Path, std::ios::binary | std::ios::in | std::ios::out);
+		File.seekp(static_cast<std::streamoff>(Offset));
+		File.put(Original);
+	}
+
+	ExpressionCache Cache;
+	WL_CHECK(Cache.Open(Path));
+	Cache.Close();
+
+	WL_CHECK(!Cache.Open(GetCachePath("LiveCalculatorTestsMissing.cache")));
+	std::filesystem::remove(Path);
+}
+
+// Padding bytes of nodes and literals must not reach the file, the same formulas always give the same bytes
+WL_TEST(ExpressionCacheIsReproducible)
+{
+	const std::string FirstPath = GetCachePath("LiveCalculatorTestsFirst.cache");
+	const std::string SecondPath = GetCachePath("LiveCalculatorTestsSecond.cache");
+	WL_CHECK(WriteCache(FirstPath));
+	WL_CHECK(WriteCache(SecondPath));
+
+	const std::string First = ReadFile(FirstPath);
+	const std::string Second = ReadFile(SecondPath);
+	WL_CHECK(First.size() >= sizeof(ExpressionCacheFormat::Header));
+	WL_CHECK(First == Second);
+
+	if (First.size() >= sizeof(ExpressionCacheFormat::Header))
+	{
+		ExpressionCacheFormat::Header FileHeader;
+		std::memcpy(&FileHeader, First.data(), sizeof(FileHeader));
+
+		// Equal files could still share stale bytes, the gaps between fields must be zero
+		bool IsPaddingZero = true;
+
+		for (uint32_t Index = 0; Index < FileHeader.NodeCount; ++Index)
+		{
+			const size_t Node = FileHeader.NodeOffset + Index * sizeof(SyntaxNode);
+
+			for (size_t Offset = offsetof(SyntaxNode, Operator) + 1; Offset < offsetof(SyntaxNode, Left); ++Offset)
+			{
+				IsPaddingZero = IsPaddingZero && First[Node + Offset] == 0;
+			}
+		}
+
+		for (uint32_t Index = 0; Index < FileHeader.LiteralCount; ++Index)
+		{
+			const size_t Literal = FileHeader.LiteralOffset + Index * sizeof(Number);
+
+			for (size_t Offset = offsetof(Number, IsInt) + 1; Offset < offsetof(Number, IntValue); ++Offset)
+			{
+				IsPaddingZero = IsPaddingZero && First[Literal + Offset] == 0;
+			}
+		}
+
+		WL_CHECK(IsPaddingZero);
+	}
+
+	std::filesystem::remove(FirstPath);
+	std::filesystem::remove(SecondPath);
+}
+
+// Writers of the same path must not share a temporary file, the last rename wins and nothing is left behind
+WL_TEST(ExpressionCacheConcurrentWriters)
+{
+	const std::filesystem::path Directory = std::filesystem::temp_directory_path() / "LiveCalculatorTestsWriters";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directory(Directory);
+
+	const std::string Path = (Directory / "Shared.cache").string();
+	std::vector<std::thread> Writers;
+	std::atomic<uint32_t> FailedWrites = 0;
+
+	for (int32_t WriterIndex = 0; WriterIndex < 8; ++WriterIndex)
+	{
+		Writers.emplace_back([&]()
+		{
+			for (int32_t Write = 0; Write < 20; ++Write)
+			{
+				if (!WriteCache(Path))
+				{
+					FailedWrites++;
+				}
+			}
+		});
+	}
+
+	for (std::thread& Writer : Writers)
+	{
+		Writer.join();
+	}
+
+	WL_CHECK(FailedWrites == 0);
+
+	ExpressionCache Cache;
+	WL_CHECK(Cache.Open(Path));
+	Cache.Close();
+
+	const size_t FileCount = static_cast<size_t>(std::distance(std::filesystem::directory_iterator(Directory), std::filesystem::directory_iterator()));
+	WL_CHECK(FileCount == 1);
+
+	std::filesystem::remove_all(Directory);
+}
@@ -0,0 +1,53 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Jit/Jit.h"
+#include "Parser/Parser.h"
+
+// Compiled code and Interpreter::Visit on the same random trees. Compile() only returns code on x86-64 with
+// Number built on doubles ("premake5 --number=double"), everywhere else this checks the fallback.
+WL_TEST(JitMatchesInterpreter)
+{
+	std::mt19937_64 Random(30);
+	uint32_t CompiledCount = 0;
+
+	for (int32_t Iteration = 0; Iteration < 20000; ++Iteration)
+	{
+		const std::string Formula = Test::GenerateFormula(Random, 6);
+
+		ErrorManager Errors;
+		SyntaxTree Tree;
+		const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+		WL_CHECK(!Errors.HasErrors());
+
+		ErrorManager InterpreterErrors;
+		const Number Expected = Interpreter::Visit(Tree, Root, InterpreterErrors);
+
+		const std::unique_ptr<CompiledExpression> Compiled = Jit::Compile(Tree, Root);
+		Number Result;
+
+		// Code that ran to the end has to agree, code that bailed out leaves the result to the interpreter
+		if (Compiled != nullptr && Compiled->Run(Result))
+		{
+			CompiledCount++;
+			WL_CHECK(!InterpreterErrors.HasErrors());
+			WL_CHECK(Result.IsIdenticalTo(Expected));
+		}
+
+		ErrorManager JitErrors;
+		Result = Jit::Evaluate(Compiled.get(), Tree, Root, JitErrors);
+		WL_CHECK(JitErrors.HasErrors() == InterpreterErrors.HasErrors());
+		WL_CHECK(InterpreterErrors.HasErrors() || Result.IsIdenticalTo(Expected));
+	}
+
+#if defined(__x86_64__) || defined(_M_X64)
+	if constexpr (sizeof(Number::FloatType) == sizeof(double))
+	{
+		WL_CHECK(CompiledCount > 10000);
+	}
+#endif
+}
@@ -0,0 +1,33 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "CodeGen/KernelEmitter.h"
+#include "ErrorManager.h"
+#include "Parser/Parser.h"
+
+// Names end up in the generated header as function names and string literals, anything else must be rejected
+WL_TEST(KernelNamesAreIdentifiers)
+{
+	KernelEmitter Emitter;
+
+	WL_CHECK(Emitter.IsValidName("Polynomial"));
+	WL_CHECK(Emitter.IsValidName("_Area2"));
+
+	WL_CHECK(!Emitter.IsValidName(""));
+	WL_CHECK(!Emitter.IsValidName("2Fast"));
+	WL_CHECK(!Emitter.IsValidName("Two Words"));
+	WL_CHECK(!Emitter.IsValidName("Quote\""));
+	WL_CHECK(!Emitter.IsValidName("Caf\xC3\xA9"));
+	WL_CHECK(!Emitter.IsValidName("return"));
+	WL_CHECK(!Emitter.IsValidName("GKernels"));
+
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult("1 + 2", Tree, Errors);
+	WL_CHECK(!Errors.HasErrors());
+
+	Emitter.AddKernel(Tree, Root, "Sum", "1 + 2");
+	WL_CHECK(!Emitter.IsValidName("Sum"));
+}
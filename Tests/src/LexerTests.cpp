@@ -0,0 +1,88 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+
+// Lexes Input, which must be a single literal, and returns its token
+static Token LexLiteral(const std::string_view Input)
+{
+	ErrorManager Errors;
+	const std::pmr::vector<Token> Tokens = Lexer::GetTokens(Input, Errors);
+
+	WL_CHECK(!Errors.HasErrors());
+	WL_CHECK(Tokens.size() == 2 && Tokens[1].Type == TYPE_EOF);
+
+	return Tokens.empty() ? Token(TYPE_EOF) : Tokens[0];
+}
+
+WL_TEST(LexerReadsEveryLiteralForm)
+{
+	const std::pair<const char*, Number> Integers[] =
+	{
+		{ "0", Number(int64_t{ 0 }) },
+		{ "42", Number(int64_t{ 42 }) },
+		{ "1_000_000", Number(int64_t{ 1000000 }) },
+		{ "0x1F", Number(int64_t{ 31 }) },
+		{ "0XfF_fF", Number(int64_t{ 65535 }) },
+		{ "99999999999999999999", Number(INT64_MAX) }
+	};
+
+	for (const auto& [Input, Expected] : Integers)
+	{
+		const Token Literal = LexLiteral(Input);
+
+		WL_CHECK(Literal.Type == TYPE_INT);
+		WL_CHECK(Literal.Value == Input);
+		WL_CHECK(Literal.Literal.IsIdenticalTo(Expected));
+	}
+
+	const std::pair<const char*, const char*> Floats[] =
+	{
+		{ "4.5", "4.5" },
+		{ "7.", "7" },
+		{ "2.5e-3", "2.5e-3" },
+		{ "6E+23", "6E+23" },
+		{ "1e9", "1e9" },
+		{ "1_024.000_5", "1024.0005" },
+		{ "1e99999", "1e99999" }
+	};
+
+	for (const auto& [Input, Digits] : Floats)
+	{
+		const Token Literal = LexLiteral(Input);
+
+		WL_CHECK(Literal.Type == TYPE_FLOAT);
+		WL_CHECK(Literal.Value == Input);
+		WL_CHECK(Literal.Literal.IsIdenticalTo(Number(NumberPolicy::Parse(Digits))));
+	}
+}
+
+// An exponent or separator that is not followed by a digit ends the literal before it
+WL_TEST(LexerStopsBeforeDanglingSuffixes)
+{
+	const std::pair<const char*, size_t> Inputs[] =
+	{
+		{ "1e+", 1 },
+		{ "2E-x", 1 },
+		{ "3_", 1 },
+		{ "4__5", 1 },
+		{ "0x", 1 },
+		{ "0x_1", 1 },
+		{ "5\xC3\xA9", 1 },
+		{ "6_\xFF", 1 },
+		{ "0x\xC3", 1 }
+	};
+
+	for (const auto& [Input, Length] : Inputs)
+	{
+		ErrorManager Errors;
+		const std::pmr::vector<Token> Tokens = Lexer::GetTokens(Input, Errors);
+
+		WL_CHECK(Errors.HasErrors());
+		WL_CHECK(Tokens.empty());
+		WL_CHECK(Errors.HasErrors() && Errors.GetFirstError()->Start == static_cast<int32_t>(Length));
+	}
+}
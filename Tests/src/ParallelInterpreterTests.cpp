@@ -0,0 +1,42 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/ParallelInterpreter.h"
+#include "Parser/Parser.h"
+
+// Tiny thresholds so even generated formulas are split into spine and chunks
+WL_TEST(ParallelInterpreterMatchesInterpreter)
+{
+	std::mt19937_64 Random(34);
+
+	for (int32_t Iteration = 0; Iteration < 5000; ++Iteration)
+	{
+		const std::string Formula = Test::GenerateFormula(Random, 8);
+
+		ErrorManager Errors;
+		SyntaxTree Tree;
+		const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+		const Number Expected = Interpreter::Visit(Tree, Root, Errors);
+
+		ParallelOptions Options;
+		Options.SequentialThreshold = 1 + static_cast<uint32_t>(Random() % 8);
+		Options.ThreadCount = 1 + static_cast<uint32_t>(Random() % 4);
+
+		ErrorManager ParallelErrors;
+		const Number Result = ParallelInterpreter::Visit(Tree, Root, ParallelErrors, Options);
+
+		WL_CHECK(ParallelErrors.HasErrors() == Errors.HasErrors());
+		WL_CHECK(Errors.HasErrors() || Result.IsIdenticalTo(Expected));
+
+		// The division by zero Interpreter::Visit reaches first
+		if (Errors.HasErrors() && ParallelErrors.HasErrors())
+		{
+			WL_CHECK(ParallelErrors.GetErrors()[0].Start == Errors.GetErrors()[0].Start);
+			WL_CHECK(ParallelErrors.GetErrors()[0].End == Errors.GetErrors()[0].End);
+		}
+	}
+}
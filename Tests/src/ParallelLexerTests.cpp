@@ -0,0 +1,83 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Lexer/Lexer.h"
+#include "Lexer/ParallelLexer.h"
+
+static bool IsSamePosition(const Position& First, const Position& Second)
+{
+	return First.Index == Second.Index && First.LineNumber == Second.LineNumber && First.ColumnNumber == Second.ColumnNumber;
+}
+
+static bool IsSameToken(const Token& First, const Token& Second)
+{
+	return First.Type == Second.Type
+		&& First.Value.data() == Second.Value.data()
+		&& First.Value.size() == Second.Value.size()
+		&& First.Literal.IsIdenticalTo(Second.Literal)
+		&& IsSamePosition(First.Start, Second.Start)
+		&& IsSamePosition(First.End, Second.End);
+}
+
+// Inputs of a few chunks, full of numbers that a careless cut would split
+WL_TEST(ParallelLexerMatchesLexer)
+{
+	static constexpr const char* NUMBERS[] = { "1", "23", "4.5", "7.", "0.5", "0x1F", "1_000", "2.5e-3", "6E+23", "1e9" };
+	static constexpr const char* SEPARATORS[] = { " ", "\t", "+", "-", "*", "/", "(", ")", " + " };
+
+	std::mt19937_64 Random(35);
+
+	for (int32_t Iteration = 0; Iteration < 6; ++Iteration)
+	{
+		const size_t Length = ParallelLexer::MIN_CHUNK_SIZE * 2 + Random() % (ParallelLexer::MIN_CHUNK_SIZE * 2);
+		std::string Input;
+		Input.reserve(Length + 16);
+
+		while (Input.size() < Length)
+		{
+			Input += NUMBERS[Random() % std::size(NUMBERS)];
+			Input += SEPARATORS[Random() % std::size(SEPARATORS)];
+		}
+
+		// Illegal characters, only the first one is reported
+		if (Iteration % 3 == 1)
+		{
+			Input[Length / 2 + Random() % 1000] = '#';
+			Input[Length - 10] = '\n';
+		}
+
+		ErrorManager Errors;
+		ErrorManager ParallelErrors;
+		const std::pmr::vector<Token> Tokens = Lexer::GetTokens(Input, Errors);
+		const std::pmr::vector<Token> ParallelTokens = ParallelLexer::GetTokens(Input, ParallelErrors, 4);
+
+		WL_CHECK(Tokens.size() == ParallelTokens.size());
+
+		// Without an injected '#' every chunk holds tokens, the comparison must not pass by lexing nothing
+		if (Iteration % 3 != 1)
+		{
+			WL_CHECK(Tokens.size() > 1);
+		}
+
+		for (size_t Index = 0; Index < std::min(Tokens.size(), ParallelTokens.size()); ++Index)
+		{
+			if (!IsSameToken(Tokens[Index], ParallelTokens[Index]))
+			{
+				WL_CHECK(IsSameToken(Tokens[Index], ParallelTokens[Index]));
+				break;
+			}
+		}
+
+		WL_CHECK(Errors.GetErrors().size() == ParallelErrors.GetErrors().size());
+
+		if (Errors.HasErrors() && ParallelErrors.HasErrors())
+		{
+			const Error& Expected = *Errors.GetFirstError();
+			const Error& Actual = *ParallelErrors.GetFirstError();
+			WL_CHECK(Expected.Code == Actual.Code && Expected.Start == Actual.Start && Expected.Character == Actual.Character);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Parser/Parser.h"
+
+struct RecoveredParse
+{
+	Number Partial;
+	std::vector<EErrorCode> Codes;
+	std::vector<int32_t> Starts;
+};
+
+// Evaluates whatever the parser recovered, like the UI does while typing
+static RecoveredParse ParseWithErrors(const std::string_view Formula)
+{
+	RecoveredParse Result;
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+
+	for (const Error& Reported : Errors.GetErrors())
+	{
+		Result.Codes.push_back(Reported.Code);
+		Result.Starts.push_back(Reported.Start);
+	}
+
+	if (Tree.GetNode(Root).Type != NODE_TYPE_ERROR)
+	{
+		ErrorManager RuntimeErrors;
+		Result.Partial = Interpreter::Visit(Tree, Root, RuntimeErrors);
+	}
+
+	return Result;
+}
+
+// Half-typed input keeps the operands that are there, every syntax error is reported once
+WL_TEST(ParserRecoversFromSyntaxErrors)
+{
+	const RecoveredParse OpenBracket = ParseWithErrors("3 + (4 *");
+	WL_CHECK(OpenBracket.Partial.IsIdenticalTo(Number(int64_t{ 7 })));
+	WL_CHECK(OpenBracket.Codes.size() == 2);
+
+	const RecoveredParse MissingOperand = ParseWithErrors("1 + )");
+	WL_CHECK(MissingOperand.Partial.IsIdenticalTo(Number(int64_t{ 1 })));
+	WL_CHECK(MissingOperand.Codes == std::vector<EErrorCode>{ ERROR_EXPECTED_NUMBER });
+	WL_CHECK(MissingOperand.Starts == std::vector<int32_t>{ 4 });
+
+	// The stray bracket is skipped, what follows it still counts
+	const RecoveredParse StrayBracket = ParseWithErrors("1 ) + 2");
+	WL_CHECK(StrayBracket.Partial.IsIdenticalTo(Number(int64_t{ 3 })));
+	WL_CHECK(StrayBracket.Codes == std::vector<EErrorCode>{ ERROR_EXPECTED_OPERATOR });
+	WL_CHECK(StrayBracket.Starts == std::vector<int32_t>{ 2 });
+
+	const RecoveredParse StrayBrackets = ParseWithErrors("2 ) ) * 5 - )");
+	WL_CHECK(StrayBrackets.Partial.IsIdenticalTo(Number(int64_t{ 10 })));
+	WL_CHECK((StrayBrackets.Codes == std::vector<EErrorCode>{ ERROR_EXPECTED_OPERATOR, ERROR_EXPECTED_OPERATOR, ERROR_EXPECTED_NUMBER }));
+
+	const RecoveredParse MissingOperator = ParseWithErrors("1 ) 2");
+	WL_CHECK(MissingOperator.Partial.IsIdenticalTo(Number(int64_t{ 1 })));
+	WL_CHECK((MissingOperator.Codes == std::vector<EErrorCode>{ ERROR_EXPECTED_OPERATOR, ERROR_EXPECTED_OPERATOR }));
+
+	const RecoveredParse Nothing = ParseWithErrors(")");
+	WL_CHECK(Nothing.Codes == std::vector<EErrorCode>{ ERROR_EXPECTED_NUMBER });
+}
@@ -0,0 +1,82 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/RationalInterpreter.h"
+#include "Parser/Parser.h"
+
+#include <cmath>
+
+static std::optional<Rational> EvaluateExact(const std::string_view Formula)
+{
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+	std::optional<Rational> Result = RationalInterpreter::Visit(Tree, Root, Errors, nullptr, Formula);
+	WL_CHECK(!Errors.HasErrors());
+	return Result;
+}
+
+static bool IsClose(const long double Actual, const long double Expected)
+{
+	return std::fabs(Actual - Expected) <= std::fabs(Expected) * 1e-15L;
+}
+
+WL_TEST(RationalIsExact)
+{
+	const std::optional<Rational> Third = EvaluateExact("1/3*3");
+	WL_CHECK(Third && Third->IsInteger() && Third->ToString() == "1");
+
+	const std::optional<Rational> Tenth = EvaluateExact("0.1 + 0.2");
+	WL_CHECK(Tenth && Tenth->ToString() == "3/10");
+
+	const std::optional<Rational> Large = EvaluateExact("9223372036854775807 * 9223372036854775807 - 1");
+	WL_CHECK(Large && Large->ToString() == "85070591730234615847396907784232501248");
+}
+
+// Parts far past the range of long double, with a quotient well inside it
+WL_TEST(RationalToLongDoubleOfLargeParts)
+{
+	const std::pair<const char*, long double> Cases[] =
+	{
+		{ "1e300", 1e300L },
+		{ "2e300/3", 2e300L / 3 },
+		{ "1/1e300", 1e-300L },
+		{ "1e300*1e300*1e300*1e300/(3e300*1e300*1e300*1e300)", 1.0L / 3 },
+		{ "(1e300*1e300 + 1)/(1e300*1e10)", 1e290L },
+		{ "1/(7*1e300)", 1.0L / 7 / 1e300L }
+	};
+
+	for (const auto& [Formula, Expected] : Cases)
+	{
+		const std::optional<Rational> Result = EvaluateExact(Formula);
+		WL_CHECK(Result && IsClose(Result->ToLongDouble(), Expected));
+	}
+}
+
+// Float literals keep their decimal value whatever type they were rounded to
+WL_TEST(RationalReadsFloatLiteralsExactly)
+{
+	WL_CHECK(Rational::FromFloat(0.1f)->ToString() == "1/10");
+	WL_CHECK(Rational::FromFloat(0.1)->ToString() == "1/10");
+	WL_CHECK(Rational::FromFloat(0.1L)->ToString() == "1/10");
+	WL_CHECK(Rational::FromFloat(-2.5e-3f)->ToString() == "-1/400");
+	WL_CHECK(!Rational::FromFloat(std::numeric_limits<float>::infinity()));
+
+	WL_CHECK(Rational::FromDecimal("1_000.5E-1_0")->ToString() == "2001/20000000000");
+	WL_CHECK(Rational::FromDecimal("6e+2")->ToString() == "600");
+	WL_CHECK(Rational::FromDecimal("1e300")->ToString() == "1" + std::string(300, '0'));
+	WL_CHECK(!Rational::FromDecimal("1e5001"));
+	WL_CHECK(!Rational::FromDecimal("1e99999999999"));
+	WL_CHECK(!Rational::FromDecimal("1e-2147483648"));
+	WL_CHECK(!Rational::FromDecimal("1e-9223372036854775808"));
+
+	// A tree without its source text, as from an ExpressionCache, reads the rounded literal in the type it has
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult("0.1 + 0.2", Tree, Errors);
+	const std::optional<Rational> Result = RationalInterpreter::Visit(Tree, Root, Errors);
+	WL_CHECK(Result && Result->ToString() == "3/10");
+}
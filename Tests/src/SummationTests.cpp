@@ -0,0 +1,172 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Interpreter/Rational.h"
+#include "Parser/Parser.h"
+
+#include <cmath>
+
+using FloatType = Number::FloatType;
+
+// Long chains of terms that are themselves bracketed chains, so flattened sums nest in each other's operands
+static std::string GenerateNestedSum(std::mt19937_64& Random, const uint32_t Depth)
+{
+	static constexpr const char* LITERALS[] = { "1", "7", "255", "9223372036854775807", "0.1", "2.5e-3", "1e300", "-0.0" };
+
+	std::string Result;
+	const uint64_t TermCount = Summation::MIN_FLAT_TERMS + Random() % 8;
+
+	for (uint64_t Term = 0; Term < TermCount; ++Term)
+	{
+		if (Term != 0)
+		{
+			Result += Random() % 2 == 0 ? " + " : " - ";
+		}
+
+		if (Depth > 0 && Random() % 4 == 0)
+		{
+			Result += "(" + GenerateNestedSum(Random, Depth - 1) + ")";
+		}
+		else if (Random() % 8 == 0)
+		{
+			Result += std::format("{} / {}", LITERALS[Random() % std::size(LITERALS)], Random() % 3);
+		}
+		else
+		{
+			Result += LITERALS[Random() % std::size(LITERALS)];
+		}
+	}
+
+	return Result;
+}
+
+// Random m * 2^e sum exactly as Rational, both modes have to stay within their error bound of that sum: about one
+// rounding of the result for compensated, one rounding per level of the tree times the sum of magnitudes for pairwise
+WL_TEST(SummationIsAccurate)
+{
+	static constexpr FloatType UNIT_ROUNDOFF = std::numeric_limits<FloatType>::epsilon() / 2;
+
+	std::mt19937_64 Random(5050);
+
+	for (int32_t Iteration = 0; Iteration < 200; ++Iteration)
+	{
+		const size_t Count = 1 + Random() % 3000;
+		std::vector<FloatType> Values;
+		Rational Exact;
+		long double Magnitude = 0;
+
+		for (size_t Index = 0; Index < Count; ++Index)
+		{
+			const int64_t Mantissa = static_cast<int64_t>(Random() % (1 << 20)) - (1 << 19);
+			const int32_t Exponent = static_cast<int32_t>(Random() % 41) - 20;
+			const Rational Scale(int64_t{ 1 } << std::abs(Exponent));
+
+			Values.push_back(std::ldexp(static_cast<FloatType>(Mantissa), Exponent));
+			Exact = Exact.AddedTo(Exponent >= 0 ? Rational(Mantissa).MultipliedBy(Scale) : Rational(Mantissa).DividedBy(Scale));
+			Magnitude += std::abs(static_cast<long double>(Values.back()));
+		}
+
+		const long double Reference = Exact.ToLongDouble();
+		const long double Levels = std::ceil(std::log2(static_cast<long double>(Count))) + 16;
+
+		const long double CompensatedError = std::abs(Summation::SumCompensated(Values) - Reference);
+		const long double PairwiseError = std::abs(Summation::SumPairwise(Values) - Reference);
+
+		WL_CHECK(CompensatedError <= 2 * UNIT_ROUNDOFF * std::abs(Reference) + Count * UNIT_ROUNDOFF * UNIT_ROUNDOFF * Magnitude);
+		WL_CHECK(PairwiseError <= Levels * UNIT_ROUNDOFF * Magnitude);
+	}
+
+	// Every 1.0 is lost next to 1e16 when adding left to right, the compensation keeps all of them
+	std::vector<FloatType> Cancelling(3002, FloatType(1));
+	Cancelling.front() = FloatType(1e16);
+	Cancelling.back() = FloatType(-1e16);
+
+	WL_CHECK(Summation::SumCompensated(Cancelling) == 3000);
+}
+
+// Infinities and NaN pass through both modes like through a left to right sum, the compensation does not turn
+// an infinite sum into NaN
+WL_TEST(SummationKeepsInfinityAndNaN)
+{
+	static constexpr FloatType INFINITY_VALUE = std::numeric_limits<FloatType>::infinity();
+	static constexpr FloatType NAN_VALUE = std::numeric_limits<FloatType>::quiet_NaN();
+
+	std::vector<FloatType> Values(100, FloatType(0.25));
+
+	for (const auto Sum : { &Summation::SumPairwise, &Summation::SumCompensated })
+	{
+		Values[17] = INFINITY_VALUE;
+		WL_CHECK(Sum(Values) == INFINITY_VALUE);
+
+		Values[17] = -INFINITY_VALUE;
+		WL_CHECK(Sum(Values) == -INFINITY_VALUE);
+
+		Values[60] = INFINITY_VALUE;
+		WL_CHECK(std::isnan(Sum(Values)));
+
+		Values[60] = FloatType(0.25);
+		Values[17] = NAN_VALUE;
+		WL_CHECK(std::isnan(Sum(Values)));
+
+		Values[17] = FloatType(0.25);
+	}
+}
+
+// One scratch reused across evaluations gives the same bits as a fresh one and is left empty after every call
+WL_TEST(SumScratchIsReusedAcrossNestedChains)
+{
+	std::mt19937_64 Random(50);
+	Interpreter::SumScratch Scratch;
+
+	for (int32_t Iteration = 0; Iteration < 2000; ++Iteration)
+	{
+		const std::string Formula = GenerateNestedSum(Random, 3);
+
+		ErrorManager Errors;
+		SyntaxTree Tree;
+		const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+		WL_CHECK(!Errors.HasErrors());
+
+		for (const ESumMode SumMode : { SUM_MODE_PAIRWISE, SUM_MODE_COMPENSATED })
+		{
+			ErrorManager FreshErrors;
+			const Number Expected = Interpreter::Visit(Tree, Root, FreshErrors, SumMode);
+
+			ErrorManager ReusedErrors;
+			const Number Result = Interpreter::Visit(Tree, Root, ReusedErrors, SumMode, Scratch);
+
+			WL_CHECK(ReusedErrors.HasErrors() == FreshErrors.HasErrors());
+			WL_CHECK(FreshErrors.HasErrors() || Result.IsIdenticalTo(Expected));
+			WL_CHECK(Scratch.Terms.empty() && Scratch.Values.empty());
+		}
+	}
+}
+
+// Integer chains wrap like the tree does in every mode, and a chain without an integer prefix keeps -0.0
+WL_TEST(FlattenedSumsKeepIntegerResults)
+{
+	const char* Formulas[] =
+	{
+		"9223372036854775807 + 1 + 2 + 3 + 4 + 5 + 6 + 7 - 8",
+		"1 - 2 - 3 - 4 - 5 - 6 - 7 - 8 - 9 - 10",
+		"(1 + 2 + 3 + 4 + 5 + 6 + 7 + 8) - (1 + 2 + 3 + 4 + 5 + 6 + 7 + 8) + 1 + 2 + 3 + 4 + 5 + 6",
+		"-0.0 - 0.0 - 0.0 - 0.0 - 0.0 - 0.0 - 0.0 - 0.0"
+	};
+
+	for (const char* Formula : Formulas)
+	{
+		const Number Expected = Test::Evaluate(Formula);
+
+		for (const ESumMode SumMode : { SUM_MODE_PAIRWISE, SUM_MODE_COMPENSATED })
+		{
+			ErrorManager Errors;
+			SyntaxTree Tree;
+			const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+			WL_CHECK(Interpreter::Visit(Tree, Root, Errors, SumMode).IsIdenticalTo(Expected));
+		}
+	}
+}
@@ -0,0 +1,76 @@
+﻿// Precompiled headers
+#include "Pch.h"
+
+#include "Test.h"
+
+#include "ErrorManager.h"
+#include "Interpreter/Interpreter.h"
+#include "Parser/Parser.h"
+
+static uint32_t GFailureCount = 0;
+
+std::vector<Test::TestCase>& Test::GetTests()
+{
+	// Function local so registration from other translation units does not depend on initialization order
+	static std::vector<TestCase> Tests;
+	return Tests;
+}
+
+void Test::ReportFailure(const char* File, const int32_t Line, const char* Condition)
+{
+	printf("  %s(%d): check failed: %s\n", File, Line, Condition);
+	GFailureCount++;
+}
+
+uint32_t Test::GetFailureCount()
+{
+	return GFailureCount;
+}
+
+Number Test::Evaluate(const std::string_view Formula, bool* HasErrors)
+{
+	ErrorManager Errors;
+	SyntaxTree Tree;
+	const uint32_t Root = Parser::GetExpressionResult(Formula, Tree, Errors);
+	const Number Result = Errors.HasErrors() ? Number(int64_t{ 0 }) : Interpreter::Visit(Tree, Root, Errors);
+
+	if (HasErrors != nullptr)
+	{
+		*HasErrors = Errors.HasErrors();
+	}
+
+	return Result;
+}
+
+std::string Test::GenerateFormula(std::mt19937_64& Random, const uint32_t Depth)
+{
+	static constexpr const char* LITERALS[] =
+	{
+		"0", "1", "2", "3", "7", "10", "255", "0x7f", "1_000_000", "4294967296", "9223372036854775807",
+		"0.0", "0.5", "0.1", "2.25", "3.", "1e3", "2.5e-3", "1e300", "1E-300", "6.02e+23"
+	};
+
+	static constexpr char OPERATORS[] = { '+', '-', '*', '/' };
+
+	const uint64_t Choice = Random() % 8;
+
+	if (Depth == 0 || Choice < 3)
+	{
+		return LITERALS[Random() % std::size(LITERALS)];
+	}
+
+	if (Choice == 3)
+	{
+		return std::format("{}{}", Random() % 2 == 0 ? '-' : '+', GenerateFormula(Random, Depth - 1));
+	}
+
+	if (Choice == 4)
+	{
+		return std::format("({})", GenerateFormula(Random, Depth - 1));
+	}
+
+	const std::string Left = GenerateFormula(Random, Depth - 1);
+	const std::string Right = GenerateFormula(Random, Depth - 1);
+
+	return std::format("{} {} {}", Left, OPERATORS[Random() % std::size(OPERATORS)], Right);
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "Interpreter/Number.h"
+
+#include <random>
+
+/*
+ * Minimal test registry. WL_TEST defines a test and registers it before main() runs, WL_CHECK reports a failed
+ * condition with its location and lets the test carry on:
+ *
+ *		WL_TEST(AdditionOfInts)
+ *		{
+ *			WL_CHECK(Test::Evaluate("1+2").IntValue == 3);
+ *		}
+ */
+namespace Test
+{
+	using TestFunction = void (*)();
+
+	struct TestCase
+	{
+		const char* Name;
+		TestFunction Function;
+	};
+
+	std::vector<TestCase>& GetTests();
+
+	void ReportFailure(const char* File, int32_t Line, const char* Condition);
+
+	[[nodiscard]] uint32_t GetFailureCount();
+
+	struct Registrar
+	{
+		Registrar(const char* Name, const TestFunction Function)
+		{
+			GetTests().push_back({ Name, Function });
+		}
+	};
+
+	// Lexer, Parser and Interpreter::Visit, HasErrors is set when any stage reported an error
+	Number Evaluate(std::string_view Formula, bool* HasErrors = nullptr);
+
+	// Well formed formula of int, float, hex and scientific literals, signs and brackets nested up to Depth levels.
+	// Divisions by zero, integer overflow and float overflow are all common on purpose.
+	std::string GenerateFormula(std::mt19937_64& Random, uint32_t Depth);
+}
+
+#define WL_TEST(Name) \
+	static void Name(); \
+	static const Test::Registrar Name##Registrar(#Name, Name); \
+	static void Name()
+
+#define WL_CHECK(Condition) \
+	do \
+	{ \
+		if (!(Condition)) \
+		{ \
+			Test::ReportFailure(__FILE__, __LINE__, #Condition); \
+		} \
+	} while (false)